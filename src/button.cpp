@@ -6,9 +6,9 @@
 Button::Button(string lab, float x, float y) : label(lab), xPos(x), yPos(y) {}
 
 //--------------------------------------------------------------
-void Button::draw() {
+void Button::draw(bool hover) { // hover comes from the last mouse event, nothing is tested while drawing
     ofPushStyle();
-    if(getHover()){ // lighter color when hovered over
+    if(hover){ // lighter color when hovered over
         ofFill();
         ofSetColor(200);
         ofDrawRectangle(xPos, yPos, xSize, ySize);
@@ -29,9 +29,9 @@ void Button::mousePressed(void (Deck::*action)(), Deck& obj) {
 }
 
 //--------------------------------------------------------------
-bool Button::getHover() { // returns true if the mose is over the button
-    return ofGetMouseX() > xPos &&
-    ofGetMouseY() > yPos &&
-    ofGetMouseX() < xPos + xSize &&
-    ofGetMouseY() < yPos + ySize;
+bool Button::contains(float x, float y) { // returns true if the point is on the button
+    return x > xPos &&
+    y > yPos &&
+    x < xPos + xSize &&
+    y < yPos + ySize;
 }
@@ -10,9 +10,9 @@
 class Button {
 public:
     Button(string lab, float x, float y);
-    void draw();
+    void draw(bool hover);
     void mousePressed(void (Deck::*action)(), Deck& obj);
-    bool getHover();
+    bool contains(float x, float y);
 
 
 private:
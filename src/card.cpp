@@ -2,19 +2,16 @@
 #include "card.hpp"
 
 //--------------------------------------------------------------
-Card::Card(int val) : value(val) {
+Card::Card(int val, const CardAtlas &a) : value(val), atlas(&a) {
     // begin from https://rosettacode.org/wiki/Deal_cards_for_FreeCell#OOP_version
     rank = value / 4; // calc rank value
     suit = value % 4; // calc suit value
-    stringstream s;
-    s << ranks[rank] << suits[suit]; // create file name
     // end from https://rosettacode.org/wiki/Deal_cards_for_FreeCell#OOP_version
-    face.load("ca/"+s.str()+".png"); // load image
     if(suit == 1 || suit == 2) color = 0; // asign color black
     else color = 1; // asign color red
     size.x = ofGetWidth()/10; // calc size x
-    float scale = face.getWidth()/size.x; // calc scale
-    size.y = face.getHeight()/scale; // calc size y and scale it
+    float scale = atlas->getCellSize().x/size.x; // calc scale
+    size.y = atlas->getCellSize().y/scale; // calc size y and scale it
     // VARIABLE
     active = false; // card is passive
     hint = false; // hint is off
@@ -39,7 +36,7 @@ void Card::drawFace(){
     ofNoFill();
     ofDrawRectangle(position.x, position.y, size.x, size.y); // draw a nice border around the card
     ofPopStyle();
-    face.draw(position.x,position.y,size.x,size.y); // draw the card
+    atlas->draw(value, position.x, position.y, size.x, size.y); // draw the card's cell of the atlas
 }
 
 //--------------------------------------------------------------
@@ -122,26 +119,6 @@ bool Card::getTop(){
     return top;
 }
 
-//--------------------------------------------------------------
-void Card::pushPrevFcs(const int & idx){
-    prevFcs.push_back(idx);
-}
-
-//--------------------------------------------------------------
-void Card::popPrevFcs(){
-    prevFcs.pop_back();
-}
-
-//--------------------------------------------------------------
-int Card::getPrevFcsSize(){
-    return prevFcs.size();
-}
-
-//--------------------------------------------------------------
-int Card::getPrevFcs(const int & size){
-    return prevFcs[size];
-}
-
 //--------------------------------------------------------------
 const ofVec2f Card::getSize(){
     return size;
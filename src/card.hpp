@@ -4,13 +4,14 @@
 #define card_hpp
 
 #include "ofMain.h"
+#include "cardAtlas.hpp"
 
 
 //------------------------------------------------------------------------------
 
 class Card {
 public:
-    Card(int val);
+    Card(int val, const CardAtlas &a);
     void draw();
     void setHint(bool h);
     bool getHint();
@@ -26,10 +27,6 @@ public:
     bool getInteractive();
     void setTop(bool t);
     bool getTop();
-    void pushPrevFcs(const int & idx);
-    void popPrevFcs();
-    int getPrevFcs(const int & size);
-    int getPrevFcsSize();
     const ofVec2f getSize();
     const bool getColour();
     const int getRank();
@@ -37,11 +34,8 @@ public:
 private:
     // initialised before setup (used for calc suit and rank)
     int value; // card's unique id
-    // setup (used for loading texture)
-    const char* suits = "CDHS";
-    const char* ranks = "A23456789TJQK";
     // whole program
-    ofImage face; // card's texture
+    const CardAtlas *atlas; // shared texture holding the card's face
     bool color; // card's color
     int rank; // card's rank
     int suit; // card's suit
@@ -53,7 +47,6 @@ private:
     bool top; // is the card on top of the column
     bool onTopOfActive; // is the card on top of the active card
     bool hint; // if hint is on
-    vector<int> prevFcs; // used in undo collects information of index no in the free cell
     void drawFace(); // draw card
     void drawOverlay(bool condition, ofColor col); // draw overlay
 };
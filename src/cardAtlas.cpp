@@ -0,0 +1,82 @@
+
+
+#include "cardAtlas.hpp"
+
+//--------------------------------------------------------------
+CardAtlas::CardAtlas() : loaded(false) {}
+
+//--------------------------------------------------------------
+bool CardAtlas::load(const string &folder, const string &home) { // once at startup, cards never touch the disk again
+    ofPixels atlas;
+    string path = folder + "/" + ATLAS_FILE;
+    if(ofLoadImage(atlas, path)) { // shipped or saved by an earlier run
+        cellSize.x = atlas.getWidth() / ATLAS_COLUMNS - ATLAS_PADDING;
+        cellSize.y = atlas.getHeight() / ATLAS_ROWS - ATLAS_PADDING;
+    } else {
+        if(!build(folder, home, atlas)) return false;
+        ofSaveImage(atlas, path); // delete it after changing the card pictures
+    }
+    texture.allocate(atlas);
+    texture.loadData(atlas);
+    loaded = true;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool CardAtlas::build(const string &folder, const string &home, ofPixels &atlas) { // pastes every picture into its cell
+    const char* suits = "CDHS";
+    const char* ranks = "A23456789TJQK";
+    ofPixels picture;
+    for(int i = 0; i <= ATLAS_HOME; i++) {
+        string name = home;
+        if(i < NUMBER_OF_CARDS) {
+            stringstream s;
+            s << folder << "/" << ranks[cardRank(i)] << suits[cardSuit(i)] << ".png"; // same names the cards loaded
+            name = s.str();
+        }
+        if(!ofLoadImage(picture, name)) {
+            ofLogError("CardAtlas", "can't load " + name);
+            return false;
+        }
+        picture.setImageType(OF_IMAGE_COLOR_ALPHA); // cards come without alpha, home with it
+        if(i == 0) { // the first picture sets the cell size
+            cellSize.x = picture.getWidth();
+            cellSize.y = picture.getHeight();
+            atlas.allocate(ATLAS_COLUMNS * (cellSize.x + ATLAS_PADDING), ATLAS_ROWS * (cellSize.y + ATLAS_PADDING), OF_PIXELS_RGBA);
+            atlas.setColor(ofColor(0, 0, 0, 0)); // transparent everywhere else
+        }
+        ofVec2f pos = getCellPosition(i);
+        picture.pasteInto(atlas, pos.x, pos.y);
+    }
+    ofVec2f white = getCellPosition(ATLAS_WHITE);
+    for(int y = 0; y < cellSize.y; y++) {
+        for(int x = 0; x < cellSize.x; x++) atlas.setColor(white.x + x, white.y + y, ofColor(255));
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool CardAtlas::isLoaded() const {
+    return loaded;
+}
+
+//--------------------------------------------------------------
+void CardAtlas::draw(int cell, float x, float y, float w, float h) const {
+    ofVec2f pos = getCellPosition(cell);
+    texture.drawSubsection(x, y, w, h, pos.x, pos.y, cellSize.x, cellSize.y);
+}
+
+//--------------------------------------------------------------
+ofVec2f CardAtlas::getCellPosition(int cell) const { // top left corner of the cell in pixels
+    return ofVec2f((cell % ATLAS_COLUMNS) * (cellSize.x + ATLAS_PADDING), (cell / ATLAS_COLUMNS) * (cellSize.y + ATLAS_PADDING));
+}
+
+//--------------------------------------------------------------
+ofVec2f CardAtlas::getCellSize() const {
+    return cellSize;
+}
+
+//--------------------------------------------------------------
+const ofTexture& CardAtlas::getTexture() const {
+    return texture;
+}
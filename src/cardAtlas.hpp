@@ -0,0 +1,35 @@
+
+
+#ifndef cardAtlas_hpp
+#define cardAtlas_hpp
+
+#include "ofMain.h"
+#include "gameState.hpp"
+
+#define ATLAS_COLUMNS 8 // cells in a row of the atlas
+#define ATLAS_ROWS 7 // rows of cells, room for the cards and the extra cells below
+#define ATLAS_PADDING 2 // transparent pixels between cells so scaled cards don't pick up their neighbours
+#define ATLAS_HOME NUMBER_OF_CARDS // cell of the empty home picture
+#define ATLAS_WHITE (NUMBER_OF_CARDS + 1) // plain white cell for quads without a picture
+#define ATLAS_FILE "atlas.png" // prebuilt atlas kept next to the card pictures
+
+//------------------------------------------------------------------------------
+
+// every card face and the home picture in one texture, cell i holds the card with value i
+class CardAtlas {
+public:
+    CardAtlas();
+    bool load(const string &folder, const string &home);
+    bool isLoaded() const;
+    void draw(int cell, float x, float y, float w, float h) const;
+    ofVec2f getCellPosition(int cell) const;
+    ofVec2f getCellSize() const;
+    const ofTexture& getTexture() const;
+private:
+    ofTexture texture; // the whole atlas on the GPU
+    ofVec2f cellSize; // size of one picture in pixels
+    bool loaded; // is the texture ready
+    bool build(const string &folder, const string &home, ofPixels &atlas);
+};
+
+#endif /* cardAtlas_hpp */
@@ -0,0 +1,56 @@
+
+
+#ifndef cardTables_hpp
+#define cardTables_hpp
+
+#include "gameState.hpp"
+
+//------------------------------------------------------------------------------
+
+// rule answers for every card byte worked out at compile time, checks become one lookup
+struct CardTables {
+    bool stacks[2][NUMBER_OF_CARDS][NUMBER_OF_CARDS]; // [same suit rule][card][onto] can the card go on the other one
+    uint8_t safeRank[NUMBER_OF_CARDS]; // home rank both suits of the other colour need before the card may go home by itself
+    uint8_t otherSuits[NUMBER_OF_CARDS][2]; // the two suits of the other colour
+};
+
+//--------------------------------------------------------------
+constexpr CardTables makeCardTables() {
+    CardTables t = {};
+    for(int c = 0; c < NUMBER_OF_CARDS; c++) {
+        for(int o = 0; o < NUMBER_OF_CARDS; o++) {
+            bool below = cardRank(c) == cardRank(o) - 1; // one rank lower
+            t.stacks[0][c][o] = below && cardColour(c) != cardColour(o);
+            t.stacks[1][c][o] = below && cardSuit(c) == cardSuit(o);
+        }
+        t.safeRank[c] = cardRank(c) <= 1 ? 0 : cardRank(c); // aces and twos are never needed
+        int n = 0;
+        for(int suit = 0; suit < NUMBER_OF_HOMES; suit++) if(cardColour(suit) != cardColour(c)) t.otherSuits[c][n++] = suit; // suit's ace stands for its colour
+    }
+    return t;
+}
+
+static constexpr CardTables CARD_TABLES = makeCardTables();
+
+//--------------------------------------------------------------
+constexpr bool matchesCard() { // the tables against the colour Card::Card gives each value
+    for(int c = 0; c < NUMBER_OF_CARDS; c++) {
+        int color = (c % 4 == 1 || c % 4 == 2) ? 0 : 1; // as in Card::Card
+        if(cardColour(c) != (color == 1)) return false;
+        for(int o = 0; o < NUMBER_OF_CARDS; o++) {
+            int ontoColor = (o % 4 == 1 || o % 4 == 2) ? 0 : 1;
+            if(CARD_TABLES.stacks[0][c][o] != (color != ontoColor && c / 4 + 1 == o / 4)) return false;
+            if(CARD_TABLES.stacks[1][c][o] != (c % 4 == o % 4 && c / 4 + 1 == o / 4)) return false;
+        }
+        for(int i = 0; i < 2; i++) {
+            int s = CARD_TABLES.otherSuits[c][i];
+            if((s == 1 || s == 2) == (color == 0)) return false;
+        }
+        if(CARD_TABLES.otherSuits[c][0] == CARD_TABLES.otherSuits[c][1]) return false;
+    }
+    return true;
+}
+
+static_assert(matchesCard(), "card tables must follow the colour rule of Card::Card");
+
+#endif /* cardTables_hpp */
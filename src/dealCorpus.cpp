@@ -0,0 +1,95 @@
+
+
+#include "dealCorpus.hpp"
+#include "simdDealer.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------
+DealCorpus::DealCorpus() : data(nullptr), length(0), first(0), count(0) {}
+
+//--------------------------------------------------------------
+DealCorpus::~DealCorpus() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool DealCorpus::open(const std::string &path) {
+    close(); // drop an earlier file
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false; // no corpus, deals will be shuffled instead
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CorpusHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping stays valid without the descriptor
+    if(map == MAP_FAILED) return false;
+    const CorpusHeader *h = (const CorpusHeader *)map;
+    if(memcmp(h->magic, CORPUS_MAGIC, 4) != 0 || h->version != CORPUS_VERSION || h->count < 0 ||
+       (size_t)st.st_size < sizeof(CorpusHeader) + (size_t)h->count * NUMBER_OF_CARDS) { // not a corpus or cut short
+        munmap(map, st.st_size);
+        return false;
+    }
+    data = (const uint8_t *)map;
+    length = st.st_size;
+    first = h->first;
+    count = h->count;
+    return true;
+}
+
+//--------------------------------------------------------------
+void DealCorpus::close() {
+    if(data) munmap((void *)data, length);
+    data = nullptr;
+    length = 0;
+    first = 0;
+    count = 0;
+}
+
+//--------------------------------------------------------------
+bool DealCorpus::contains(long id) const {
+    return data && id >= first && id < first + count;
+}
+
+//--------------------------------------------------------------
+const uint8_t* DealCorpus::deal(long id) const { // points into the mapped file, check contains first
+    return data + sizeof(CorpusHeader) + (size_t)(id - first) * NUMBER_OF_CARDS;
+}
+
+//--------------------------------------------------------------
+long DealCorpus::getFirst() const {
+    return first;
+}
+
+//--------------------------------------------------------------
+long DealCorpus::getCount() const {
+    return count;
+}
+
+//--------------------------------------------------------------
+bool DealCorpus::write(const std::string &path, long first, long last) { // shuffles every deal of the range into a file
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    CorpusHeader h;
+    memcpy(h.magic, CORPUS_MAGIC, 4);
+    h.version = CORPUS_VERSION;
+    h.first = first;
+    h.count = last - first + 1;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    const long batch = 4096; // deals written at once
+    uint8_t *buffer = new uint8_t[batch * NUMBER_OF_CARDS];
+    for(long id = first; ok && id <= last; id += batch) {
+        long n = (last - id + 1 < batch) ? last - id + 1 : batch;
+        dealOrders(id, n, buffer);
+        ok = fwrite(buffer, NUMBER_OF_CARDS, n, f) == (size_t)n;
+    }
+    delete[] buffer;
+    if(fclose(f) != 0) ok = false;
+    return ok;
+}
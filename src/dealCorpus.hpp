@@ -0,0 +1,45 @@
+
+
+#ifndef dealCorpus_hpp
+#define dealCorpus_hpp
+
+#include "gameState.hpp"
+#include <string>
+
+#define CORPUS_MAGIC "FCDL"
+#define CORPUS_VERSION 1
+
+//------------------------------------------------------------------------------
+
+// file header, followed by NUMBER_OF_CARDS bytes per deal in the order GameState::deal lays them out
+struct CorpusHeader {
+    char magic[4]; // CORPUS_MAGIC
+    uint32_t version; // CORPUS_VERSION
+    int64_t first; // id of the first deal in the file
+    int64_t count; // amount of deals in the file
+};
+
+//------------------------------------------------------------------------------
+
+// precomputed deals mapped straight from disk, reading a deal costs no copy and no shuffling
+class DealCorpus {
+public:
+    DealCorpus();
+    ~DealCorpus();
+    bool open(const std::string &path);
+    void close();
+    bool contains(long id) const;
+    const uint8_t* deal(long id) const;
+    long getFirst() const;
+    long getCount() const;
+    static bool write(const std::string &path, long first, long last);
+private:
+    DealCorpus(const DealCorpus &) = delete;
+    DealCorpus& operator=(const DealCorpus &) = delete;
+    const uint8_t *data; // whole mapped file
+    size_t length; // size of the mapping
+    long first; // id of the first deal
+    long count; // amount of deals
+};
+
+#endif /* dealCorpus_hpp */
@@ -0,0 +1,129 @@
+
+
+#include "dealIndex.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------
+DealIndex::DealIndex() : data(nullptr), length(0), header(nullptr), deals(nullptr), ids(nullptr) {}
+
+//--------------------------------------------------------------
+DealIndex::~DealIndex() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool DealIndex::open(const std::string &path) { // same mapping as DealCorpus::open
+    close(); // drop an earlier file
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false; // no index, any deal can come up
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(IndexHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping stays valid without the descriptor
+    if(map == MAP_FAILED) return false;
+    const IndexHeader *h = (const IndexHeader *)map;
+    bool ok = memcmp(h->magic, INDEX_MAGIC, 4) == 0 && h->version == INDEX_VERSION && h->count >= 0;
+    for(int i = 0; ok && i < DIFFICULTY_LEVELS; i++) ok = h->levels[i] <= h->levels[i + 1];
+    ok = ok && h->levels[0] == 0 && h->levels[DIFFICULTY_LEVELS] <= h->count &&
+        (size_t)st.st_size >= sizeof(IndexHeader) + (size_t)h->count * sizeof(DealInfo) + h->levels[DIFFICULTY_LEVELS] * sizeof(int32_t);
+    if(!ok) { // not an index or cut short
+        munmap(map, st.st_size);
+        return false;
+    }
+    data = (const uint8_t *)map;
+    length = st.st_size;
+    header = h;
+    deals = (const DealInfo *)(data + sizeof(IndexHeader));
+    ids = (const int32_t *)(deals + h->count);
+    return true;
+}
+
+//--------------------------------------------------------------
+void DealIndex::close() {
+    if(data) munmap((void *)data, length);
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    deals = nullptr;
+    ids = nullptr;
+}
+
+//--------------------------------------------------------------
+bool DealIndex::contains(long id) const {
+    return data && id >= header->first && id < header->first + header->count;
+}
+
+//--------------------------------------------------------------
+const DealInfo& DealIndex::info(long id) const { // check contains first
+    return deals[id - header->first];
+}
+
+//--------------------------------------------------------------
+int DealIndex::levelSize(DealDifficulty level) const {
+    return data ? header->levels[level + 1] - header->levels[level] : 0;
+}
+
+//--------------------------------------------------------------
+long DealIndex::pick(DealDifficulty level, uint32_t random) const { // deal of the level, -1 when it has none
+    int n = levelSize(level);
+    if(n == 0) return -1;
+    return ids[header->levels[level] + random % n];
+}
+
+//--------------------------------------------------------------
+DealDifficulty DealIndex::difficulty(const DealInfo &d) { // DIFFICULTY_LEVELS for deals nobody should be given
+    if(d.freeCells == NOT_SOLVED) return DIFFICULTY_LEVELS;
+    bool quick = d.nodes < QUICK_SEARCH;
+    bool slow = d.nodes >= SLOW_SEARCH;
+    if(d.freeCells <= 1 && quick) return DIFFICULTY_EASY; // one free cell is enough and the way is obvious
+    if(d.freeCells <= 2 && !slow) return DIFFICULTY_MEDIUM;
+    if(d.freeCells <= 2 || (d.freeCells == 3 && !slow)) return DIFFICULTY_HARD;
+    return DIFFICULTY_EXPERT; // needs most free cells and a long search
+}
+
+//--------------------------------------------------------------
+const char* DealIndex::levelName(DealDifficulty level) {
+    switch(level) {
+        case DIFFICULTY_EASY: return "EASY";
+        case DIFFICULTY_MEDIUM: return "MEDIUM";
+        case DIFFICULTY_HARD: return "HARD";
+        case DIFFICULTY_EXPERT: return "EXPERT";
+        default: return "ANY";
+    }
+}
+
+//--------------------------------------------------------------
+bool DealIndex::write(const std::string &path, long first, const std::vector<DealInfo> &deals) {
+    IndexHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, INDEX_MAGIC, 4);
+    h.version = INDEX_VERSION;
+    h.first = first;
+    h.count = deals.size();
+    std::vector<int32_t> list; // ids level by level, in deal order within a level
+    for(int level = 0; level < DIFFICULTY_LEVELS; level++) {
+        h.levels[level] = list.size();
+        for(long i = 0; i < deals.size(); i++) if(difficulty(deals[i]) == level) list.push_back(first + i);
+    }
+    h.levels[DIFFICULTY_LEVELS] = list.size();
+    std::string tmp = path + ".tmp"; // the game may have the old file mapped
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if(!f) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+        fwrite(deals.data(), sizeof(DealInfo), deals.size(), f) == deals.size() &&
+        fwrite(list.data(), sizeof(int32_t), list.size(), f) == list.size();
+    ok = fclose(f) == 0 && ok;
+    if(!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
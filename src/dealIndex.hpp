@@ -0,0 +1,65 @@
+
+
+#ifndef dealIndex_hpp
+#define dealIndex_hpp
+
+#include "solver.hpp"
+#include <string>
+#include <vector>
+
+#define INDEX_MAGIC "FCDX"
+#define INDEX_VERSION 1
+#define NOT_SOLVED 0xFF // freeCells of a deal no run of the solver finished
+#define QUICK_SEARCH 200 // positions below which the solver found the way straight away
+#define SLOW_SEARCH 1000 // positions from which the solver had to look around a lot
+
+//------------------------------------------------------------------------------
+
+enum DealDifficulty {DIFFICULTY_EASY, DIFFICULTY_MEDIUM, DIFFICULTY_HARD, DIFFICULTY_EXPERT, DIFFICULTY_LEVELS};
+
+// what the solver found out about one deal, eight bytes
+struct DealInfo {
+    uint8_t status; // SolveStatus with every free cell
+    uint8_t freeCells; // fewest free cells the deal was solved with, NOT_SOLVED when never
+    uint16_t length; // moves of the shortest solution found
+    uint32_t nodes; // positions expanded to solve it with every free cell
+};
+
+// file header, followed by one DealInfo per deal and then the deal ids of each difficulty one level after the other
+struct IndexHeader {
+    char magic[4]; // INDEX_MAGIC
+    uint32_t version; // INDEX_VERSION
+    int64_t first; // id of the first deal
+    int64_t count; // amount of deals
+    uint32_t levels[DIFFICULTY_LEVELS + 1]; // position of each level's first id in the id list, the last one is the list size
+    uint32_t unused;
+};
+
+//------------------------------------------------------------------------------
+
+// solver results for a range of deals mapped straight from disk, written by tools/dealIndex,
+// deals of a difficulty are listed together so picking one is a single lookup
+class DealIndex {
+public:
+    DealIndex();
+    ~DealIndex();
+    bool open(const std::string &path);
+    void close();
+    bool contains(long id) const;
+    const DealInfo& info(long id) const;
+    int levelSize(DealDifficulty level) const;
+    long pick(DealDifficulty level, uint32_t random) const;
+    static DealDifficulty difficulty(const DealInfo &d);
+    static const char* levelName(DealDifficulty level);
+    static bool write(const std::string &path, long first, const std::vector<DealInfo> &deals);
+private:
+    DealIndex(const DealIndex &) = delete;
+    DealIndex& operator=(const DealIndex &) = delete;
+    const uint8_t *data; // whole mapped file
+    size_t length; // size of the mapping
+    const IndexHeader *header;
+    const DealInfo *deals;
+    const int32_t *ids; // deal ids sorted by difficulty
+};
+
+#endif /* dealIndex_hpp */
@@ -1,28 +1,53 @@
 
 
+
 #include "card.hpp"
 #include "pile.hpp"
 #include "regular.hpp"
 #include "freecell.hpp"
 #include "home.hpp"
+#include "gameState.hpp"
+#include "moveGenerator.hpp"
+#include "solver.hpp"
+#include "dealCorpus.hpp"
+#include "dealIndex.hpp"
+#include "moveLog.hpp"
+#include "replay.hpp"
+#include "cardAtlas.hpp"
+#include "tableauRenderer.hpp"
+#include "hitGrid.hpp"
+#include "profiler.hpp"
+#include "hintWorker.hpp"
 #include "ofMain.h"
+#include <unordered_map>
 
 
 #ifndef deck_hpp
 #define deck_hpp
 
 
+enum DeadEnd {DEAD_END_NONE, DEAD_END_UNWINNABLE, DEAD_END_STUCK};
+
 class Deck {
 public:
     Deck();
     void newGame();
+    void setLevel(int l);
+    string getLevel();
     void refresh();
+    bool update();
     void draw();
     bool getEnough();
     bool getNoMore();
+    DeadEnd getDeadEnd();
     bool getAutocomplete();
-    void mousePressed();
+    void mousePressed(int x, int y);
     void undo();
+    void redo();
+    void jumpTo(int n);
+    int getLogCursor();
+    int getLogSize();
+    bool saveReplay(int finalScore);
     void hint();
     void skipAutocomplete();
     void doAutocomplete();
@@ -31,16 +56,27 @@ public:
     int getScore();
     string getTime();
     int getSeconds();
+    int getDeal();
+    uint64_t getGameId();
+    static string formatTime(int seconds);
 private:
     // typedefs
     typedef pair<int,int> pint;
     template<class Piles>
     using pil = vector<shared_ptr<Piles>>;
     // game state variables
+    GameState state; // position of every card, everything below only shows it
+    DealCorpus corpus; // precomputed deals, shuffled on the spot when missing
+    DealIndex index; // how hard each deal is, made by tools/dealIndex
+    int level; // DealDifficulty new games are picked from, -1 for any deal
+    CardAtlas atlas; // every card picture in one texture, loaded once
+    TableauRenderer renderer; // the whole table in one mesh
+    HitGrid grid; // finds what is under the mouse without looking at every card
+    Hit hit; // what the last click was on
+    bool dirty; // does the mesh need rebuilding
     int deckID;
-    bool un;
+    uint64_t gameId; // tells two games of the same deal apart in the score journal
     bool act;
-    int cAtHome;
     int moves;
     bool hin;
     ofVec2f hintPos;
@@ -52,70 +88,51 @@ private:
     int score;
     bool enough;
     bool noMore;
+    DeadEnd deadEnd; // found by the worker without asking
+    uint64_t checked; // position the dead end warning was decided for
     // vectors
-    pil<Card> cards; // cards
+    pil<Card> cards; // cards indexed by their value
     pil<Pile> regs; // regular cells
     pil<Pile> fcells; // free cells
     pil<Pile> homes; // home cells
-    vector<array<int,4>> history; // undo vector
+    array<int, NUMBER_OF_CARDS> where; // location of each card in the game state
+    vector<int> order; // card values in the order they are drawn
+    MoveLog log; // moves of this game for undo and redo
+    Replay replay; // everything the player did, saved with the result
+    unordered_map<uint64_t, Move> hintCache; // next move of a known solution for each position on it
+    HintWorker worker; // works out the hint for every new position in the background
+    bool hintWanted; // HINT was pressed before the worker had an answer
     // setup
     void arrangeCards(int GI);
-    int RNG(int seed);
     void makePretty();
-    void setupInteractivity();
-    void checkForInteractive(const int &idx);
+    void placeCard(const int &idx, const ofVec2f &pos, const int &row, const int &location);
     void setupPiles();
-    void measureTime();
+    void buildTable();
+    bool measureTime();
     void drawHint();
     void deactivateStates();
     bool canActivate();
+    int find(const int target);
     template <class Piles>
-    int find(const pil<Piles> &vec, const int target);
-    template <class Piles>
-    bool clicked(const pil<Piles> &vec, const int &i);
+    int findPile(const pil<Piles> &vec, HitKind kind);
     void activateCard(const int &idx);
     pint findActive();
-    template <class Piles>
-    bool check(const pil<Piles> &vec, const pint &ac, const int target);
+    bool check(const pint &ac, const int target);
     bool anotherCard(const int &np, const pint & ac);
     bool enoughSpace(const int &onTop, bool reg);
     bool checkHomes(const pint &ac, const int &newPos);
-    void moveCard(const pint &ac, const pair <int,int> &np);
-    void occupyHistory(const pint &ac, const pint &np);
-    void occupyNp(const pint &np);
-    void fcHistory(const pint &np, const int &active);
-    template <class Piles>
-    int freePile(const pil<Piles> &vec, const int &active);
-    void newHistoryEntry(const int &np, const int type, const int adj);
-    void regHistory(const pint &np, const pint &ac);
-    template <class Piles>
-    void historyBiggerRow(const pil<Piles> &vec, const int &idx, const pint &np, const int &onTop, const int &row);
-    void cardHistory(const pint &np, const pint &ac);
-    int freeCard(const int &active);
-    void historyCardToCard(const int &idx, const pint &np, const int &onTop);
-    template <class Piles>
-    void historySmallerRow(const pil<Piles> &vec, const int &idx, const pint &np, const int &onTop, const int &row);
-    int updateLocation(const pint &ac, const pint &np);
-    int updatePosition(const pint &ac, const pint &np);
-    int assesSituation(const int &nr, const int &activeC);
-    int findUpdatedIndex(const int &active, const int &row);
-    int findHighestIndex(const int &row);
-    void reaarange(const int &row, const int &indexToMove, const int &newIndex);
-    void newActiveHistory(const int &newA, const int &target);
-    void moveCardsOnTop(const int & onTop, int & newA);
+    Move toMove(const pint &ac, const pint &np);
+    void moveCard(const Move &m, bool analyseAfter = true);
+    int homeSlot(const int &suit, bool assign);
     void checkAutocomplete();
-    bool autocompleteColumn(int idx);
-    int autocompleteCard(const int & idx);
     void checkFinished();
     void deactivate(const int &ac);
     void deactivateAllCards();
-    void undoHome(const int &idx);
-    bool checkHint(const bool fc, const int target);
-    int hintFindIdx(const bool & fc, const int & sourceIdx, const int & target);
-    template <class Piles>
-    bool hintFindTarget(const pil<Piles> &vec, const int &idx, const int &target);
-    void setHint(const int &idx, const int &targetIdx, const int &target);
-    int autoFindIdx(const int &i);
+    void syncHomes();
+    void setHint(const Move &m);
+    void analyse();
+    bool showHint();
+    bool checkDeadEnd();
 };
 
 #endif /* deck_hpp */
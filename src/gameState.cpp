@@ -0,0 +1,356 @@
+
+
+#include "gameState.hpp"
+#include "cardTables.hpp"
+#include <algorithm>
+#include <utility>
+
+//------------------------------------------------------------------------------
+
+// slots of the biggest table any variant has, they all share the keys
+static constexpr int ZOBRIST_SLOTS = std::max({BasicGameState<FreeCellRules>::slots, BasicGameState<BakersGameRules>::slots,
+    BasicGameState<EightOffRules>::slots, BasicGameState<SeahavenRules>::slots});
+
+// random number for every card in every slot, made at compile time so there is nothing to set up
+struct ZobristTable {
+    uint64_t keys[NUMBER_OF_CARDS][ZOBRIST_SLOTS];
+};
+
+//--------------------------------------------------------------
+static constexpr ZobristTable makeZobrist() {
+    ZobristTable t = {};
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for(int c = 0; c < NUMBER_OF_CARDS; c++) {
+        for(int i = 0; i < ZOBRIST_SLOTS; i++) { // splitmix64
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            t.keys[c][i] = z ^ (z >> 31);
+        }
+    }
+    return t;
+}
+
+static constexpr ZobristTable ZOBRIST = makeZobrist();
+
+//--------------------------------------------------------------
+static inline uint64_t zobrist(uint8_t card, int slot) { // slot: column * columnCapacity + row, then free cells, then home
+    return ZOBRIST.keys[card][slot];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+BasicGameState<Rules>::BasicGameState() {
+    for(int i = 0; i < columnCount; i++) sizes[i] = 0; // all columns empty
+    for(int i = 0; i < cellCount; i++) cells[i] = NO_CARD; // all free cells empty
+    for(int i = 0; i < NUMBER_OF_HOMES; i++) homes[i] = 0; // nothing at home
+    key = 0; // hash of the empty table
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+BasicGameState<Rules> BasicGameState<Rules>::deal(int GI) {
+    uint8_t order[NUMBER_OF_CARDS];
+    dealOrder(GI, order); // shuffle
+    return deal(order); // and lay out
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+BasicGameState<Rules> BasicGameState<Rules>::deal(const uint8_t *order) { // lays out 52 shuffled cards row by row
+    BasicGameState s;
+    const int toColumns = NUMBER_OF_CARDS - Rules::dealtToCells;
+    for(int i = 0; i < toColumns; i++) {
+        int col = i % columnCount;
+        s.columns[col][s.sizes[col]++] = order[i];
+    }
+    for(int i = toColumns; i < NUMBER_OF_CARDS; i++) s.cells[i - toColumns] = order[i]; // what is left starts in the free cells
+    s.key = s.rehash();
+    return s;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+void BasicGameState<Rules>::dealOrder(int GI, uint8_t *order) { // partially from https://rosettacode.org/wiki/Deal_cards_for_FreeCell#OOP_version
+    for(int i = 0; i < NUMBER_OF_CARDS; i++) order[i] = (NUMBER_OF_CARDS - 1) - i; // cards in reverse order
+    for(int i = 0; i < NUMBER_OF_CARDS - 1; i++) { // for each card
+        int j = (NUMBER_OF_CARDS - 1) - RNG(GI) % (NUMBER_OF_CARDS - i); // choose card to swap with
+        std::swap(order[i], order[j]); // swap cards
+    }
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::RNG(int seed) { // from https://rosettacode.org/wiki/Deal_cards_for_FreeCell#OOP_version
+    // the seed is a copy so every call with the same GI gives the same number, deals depend on it staying that way
+    // unsigned maths wraps like the original int version did without relying on signed overflow
+    return (((unsigned)seed * 214013u + 2531011u) & ((1U << 31) - 1)) >> 16; // generate random number based on the seed
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::columnSize(int col) const {
+    return sizes[col];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint8_t BasicGameState<Rules>::columnCard(int col, int row) const {
+    return columns[col][row];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint8_t BasicGameState<Rules>::topCard(int col) const {
+    return sizes[col] ? columns[col][sizes[col] - 1] : NO_CARD;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint8_t BasicGameState<Rules>::freeCell(int cell) const {
+    return cells[cell];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::homeRank(int suit) const { // amount of cards at home is also the rank the home expects next
+    return homes[suit];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::cardsAtHome() const {
+    return homes[0] + homes[1] + homes[2] + homes[3];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::emptyColumns() const {
+    int empty = 0;
+    for(int i = 0; i < columnCount; i++) if(sizes[i] == 0) empty++;
+    return empty;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::emptyFreeCells() const {
+    int empty = 0;
+    for(int i = 0; i < cellCount; i++) if(cells[i] == NO_CARD) empty++;
+    return empty;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::runLength(int col) const { // ordered cards at the top of the column that can be picked up together
+    int n = sizes[col];
+    if(n == 0) return 0;
+    int run = 1;
+    while(run < n && canStack(columns[col][n - run], columns[col][n - run - 1])) run++;
+    return run;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+int BasicGameState<Rules>::capacity(bool toEmptyColumn, int freeCells) const { // how many cards can be moved at once with that many free cells
+    int emptyRegs = Rules::emptyColumn == ANY_CARD ? emptyColumns() : 0; // columns only a king may fill can't hold part of a run
+    int emptyFcells = std::max(0, emptyFreeCells() - (cellCount - freeCells)); // missing cells count as taken
+    int move = 0; // cards allowed on top of the moved card
+    if (emptyRegs == 0) move = emptyFcells; // if no empty regulars we can move by amount of freecells
+    else { // if some empty regulars
+        if(toEmptyColumn) emptyRegs--; // moving to the regular means we have one less to multiply by
+        if (emptyFcells != 0) move = emptyFcells * (emptyRegs + 1); // if there are empty freecells multiply by number of regs
+        else move = emptyRegs; // if no empty free cells we can move by number of regulars
+    }
+    return move + 1; // the moved card itself
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool BasicGameState<Rules>::canStack(uint8_t card, uint8_t onto) { // neither may be NO_CARD
+    return CARD_TABLES.stacks[Rules::sameSuit][card][onto];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool BasicGameState<Rules>::canFill(uint8_t card) { // can the card start an empty column
+    return Rules::emptyColumn == ANY_CARD || cardRank(card) == KING;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint8_t BasicGameState<Rules>::baseCard(const Move &m) const { // the lowest of the moved cards
+    if(m.from >= cellBase) return cells[m.from - cellBase];
+    return columns[m.from][sizes[m.from] - m.count];
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool BasicGameState<Rules>::isLegal(const Move &m) const {
+    if(m.count == 0 || m.from == m.to || m.from >= homeBase || m.to >= homeBase + NUMBER_OF_HOMES) return false; // cards never leave home
+    if(m.from >= cellBase) { // from a free cell only the single card
+        if(m.count != 1 || cells[m.from - cellBase] == NO_CARD) return false;
+    } else if(m.count > runLength(m.from)) return false; // only ordered cards can be picked up
+    uint8_t card = baseCard(m);
+    if(m.to >= homeBase) { // home takes the next card of its suit
+        return m.count == 1 && cardSuit(card) == m.to - homeBase && homes[cardSuit(card)] == cardRank(card);
+    }
+    if(m.to >= cellBase) return m.count == 1 && cells[m.to - cellBase] == NO_CARD;
+    if(sizes[m.to] == 0) return canFill(card) && m.count <= capacity(1);
+    return canStack(card, topCard(m.to)) && m.count <= capacity(0);
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+void BasicGameState<Rules>::apply(const Move &m) { // moves the cards without checking the rules
+    const int homeSlot = columnCount * columnCapacity + cellCount;
+    uint8_t moved[columnCapacity];
+    if(m.from >= cellBase) { // take the card from the free cell
+        moved[0] = cells[m.from - cellBase];
+        cells[m.from - cellBase] = NO_CARD;
+        key ^= zobrist(moved[0], columnCount * columnCapacity + m.from - cellBase);
+    } else { // take the cards from the top of the column
+        sizes[m.from] -= m.count;
+        for(int i = 0; i < m.count; i++) {
+            moved[i] = columns[m.from][sizes[m.from] + i];
+            key ^= zobrist(moved[i], m.from * columnCapacity + sizes[m.from] + i);
+        }
+    }
+    if(m.to >= homeBase) { // put it home
+        homes[m.to - homeBase]++;
+        key ^= zobrist(moved[0], homeSlot);
+    } else if(m.to >= cellBase) { // put it in the free cell
+        cells[m.to - cellBase] = moved[0];
+        key ^= zobrist(moved[0], columnCount * columnCapacity + m.to - cellBase);
+    } else { // put them on the column
+        for(int i = 0; i < m.count; i++) {
+            key ^= zobrist(moved[i], m.to * columnCapacity + sizes[m.to]);
+            columns[m.to][sizes[m.to]++] = moved[i];
+        }
+    }
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+void BasicGameState<Rules>::revert(const Move &m) { // takes back a move apply made, the hash comes back with it
+    const int homeSlot = columnCount * columnCapacity + cellCount;
+    uint8_t moved[columnCapacity];
+    if(m.to >= homeBase) { // take the top card of the home back
+        int suit = m.to - homeBase;
+        moved[0] = --homes[suit] * 4 + suit;
+        key ^= zobrist(moved[0], homeSlot);
+    } else if(m.to >= cellBase) { // take the card from the free cell
+        moved[0] = cells[m.to - cellBase];
+        cells[m.to - cellBase] = NO_CARD;
+        key ^= zobrist(moved[0], columnCount * columnCapacity + m.to - cellBase);
+    } else { // take the cards from the top of the column
+        sizes[m.to] -= m.count;
+        for(int i = 0; i < m.count; i++) {
+            moved[i] = columns[m.to][sizes[m.to] + i];
+            key ^= zobrist(moved[i], m.to * columnCapacity + sizes[m.to] + i);
+        }
+    }
+    if(m.from >= cellBase) { // put it back in its free cell
+        cells[m.from - cellBase] = moved[0];
+        key ^= zobrist(moved[0], columnCount * columnCapacity + m.from - cellBase);
+    } else { // put them back on the column
+        for(int i = 0; i < m.count; i++) {
+            key ^= zobrist(moved[i], m.from * columnCapacity + sizes[m.from]);
+            columns[m.from][sizes[m.from]++] = moved[i];
+        }
+    }
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool BasicGameState<Rules>::isWon() const {
+    return cardsAtHome() == NUMBER_OF_CARDS;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool BasicGameState<Rules>::isSorted() const { // every column runs down in rank, so the cards can go home one by one
+    for(int i = 0; i < columnCount; i++) {
+        for(int r = 1; r < sizes[i]; r++) if(cardRank(columns[i][r]) > cardRank(columns[i][r - 1])) return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint64_t BasicGameState<Rules>::hash() const { // identity of the position, kept up to date by apply
+    return key;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint64_t BasicGameState<Rules>::rehash() const { // works the hash out from scratch
+    uint64_t h = 0;
+    for(int i = 0; i < columnCount; i++) {
+        for(int r = 0; r < sizes[i]; r++) h ^= zobrist(columns[i][r], i * columnCapacity + r);
+    }
+    for(int i = 0; i < cellCount; i++) {
+        if(cells[i] != NO_CARD) h ^= zobrist(cells[i], columnCount * columnCapacity + i);
+    }
+    for(int suit = 0; suit < NUMBER_OF_HOMES; suit++) {
+        for(int r = 0; r < homes[suit]; r++) h ^= zobrist(r * 4 + suit, columnCount * columnCapacity + cellCount);
+    }
+    return h;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+BasicGameState<Rules> BasicGameState<Rules>::canonical(bool swapSuits) const { // the same position however its columns and free cells are arranged
+    // suits of the same colour can also swap places without changing what moves are possible
+    // within one deal that almost never meets a position twice so it is only done when asked for
+    static const uint8_t swaps[4][NUMBER_OF_HOMES] = {{0, 1, 2, 3}, {3, 1, 2, 0}, {0, 2, 1, 3}, {3, 2, 1, 0}};
+    BasicGameState best;
+    for(int p = 0; p < (swapSuits ? 4 : 1); p++) {
+        const uint8_t *suit = swaps[p];
+        BasicGameState s;
+        int n = 0;
+        for(int i = 0; i < cellCount; i++) { // free cells sorted, empty ones last
+            if(cells[i] == NO_CARD) continue;
+            uint8_t card = cardRank(cells[i]) * 4 + suit[cardSuit(cells[i])];
+            int j = n++;
+            for(; j > 0 && s.cells[j - 1] > card; j--) s.cells[j] = s.cells[j - 1];
+            s.cells[j] = card;
+        }
+        uint8_t bases[columnCount]; // bottom card of each column after swapping suits
+        int order[columnCount]; // columns sorted by their bottom card, empty ones last
+        for(int i = 0; i < columnCount; i++) {
+            bases[i] = sizes[i] ? cardRank(columns[i][0]) * 4 + suit[cardSuit(columns[i][0])] : NO_CARD;
+            int j = i;
+            for(; j > 0 && bases[order[j - 1]] > bases[i]; j--) order[j] = order[j - 1];
+            order[j] = i;
+        }
+        for(int i = 0; i < columnCount; i++) {
+            const int col = order[i];
+            s.sizes[i] = sizes[col];
+            for(int r = 0; r < sizes[col]; r++) s.columns[i][r] = cardRank(columns[col][r]) * 4 + suit[cardSuit(columns[col][r])];
+        }
+        for(int i = 0; i < NUMBER_OF_HOMES; i++) s.homes[suit[i]] = homes[i];
+        s.key = s.rehash();
+        if(p == 0 || s.key < best.key) best = s; // smallest hash picks one of the arrangements
+    }
+    return best;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+uint64_t BasicGameState<Rules>::canonicalKey(bool swapSuits) const { // equal for positions that only differ in arrangement
+    return canonical(swapSuits).key;
+}
+
+//------------------------------------------------------------------------------
+
+template<class Rules> constexpr int BasicGameState<Rules>::columnCount;
+template<class Rules> constexpr int BasicGameState<Rules>::cellCount;
+template<class Rules> constexpr int BasicGameState<Rules>::cellBase;
+template<class Rules> constexpr int BasicGameState<Rules>::homeBase;
+template<class Rules> constexpr int BasicGameState<Rules>::columnCapacity;
+template<class Rules> constexpr int BasicGameState<Rules>::slots;
+
+template class BasicGameState<FreeCellRules>;
+template class BasicGameState<BakersGameRules>;
+template class BasicGameState<EightOffRules>;
+template class BasicGameState<SeahavenRules>;
@@ -0,0 +1,127 @@
+
+
+#ifndef gameState_hpp
+#define gameState_hpp
+
+#include <cstdint>
+
+#define NUMBER_OF_CARDS 52
+#define NUMBER_OF_COLUMNS 8
+#define NUMBER_OF_FREECELLS 4
+#define NUMBER_OF_HOMES 4
+#define COLUMN_CAPACITY 19 // 7 dealt cards plus a run from queen down to ace
+#define FREECELL_BASE NUMBER_OF_COLUMNS // first free cell location
+#define HOME_BASE (FREECELL_BASE + NUMBER_OF_FREECELLS) // first home location (one per suit)
+#define NO_CARD 0xFF // marks an empty slot
+#define KING 12 // rank of the kings
+
+//------------------------------------------------------------------------------
+
+// card bytes use the same value as Card (rank = value / 4, suit = value % 4)
+constexpr int cardRank(uint8_t c) { return c / 4; }
+constexpr int cardSuit(uint8_t c) { return c % 4; }
+constexpr bool cardColour(uint8_t c) { return !(cardSuit(c) == 1 || cardSuit(c) == 2); } // same rule as Card, checked in cardTables.hpp
+
+//------------------------------------------------------------------------------
+
+struct Move {
+    uint8_t from; // column, FREECELL_BASE + cell
+    uint8_t to; // column, FREECELL_BASE + cell or HOME_BASE + suit
+    uint8_t count; // number of cards moved
+};
+
+//------------------------------------------------------------------------------
+
+// what an empty column takes
+enum EmptyColumnRule {ANY_CARD, KINGS_ONLY};
+
+// rules of a variant, the engine is built once for each so none of them is looked at while playing
+struct FreeCellRules {
+    static constexpr int columns = 8;
+    static constexpr int freeCells = 4;
+    static constexpr int dealtToCells = 0; // the last cards of the deal go to the free cells, the rest row by row to the columns
+    static constexpr bool sameSuit = false; // cards stack on the other colour
+    static constexpr EmptyColumnRule emptyColumn = ANY_CARD;
+};
+
+struct BakersGameRules { // FreeCell stacking by suit
+    static constexpr int columns = 8;
+    static constexpr int freeCells = 4;
+    static constexpr int dealtToCells = 0;
+    static constexpr bool sameSuit = true;
+    static constexpr EmptyColumnRule emptyColumn = ANY_CARD;
+};
+
+struct EightOffRules { // six cards a column and half of the eight free cells dealt to
+    static constexpr int columns = 8;
+    static constexpr int freeCells = 8;
+    static constexpr int dealtToCells = 4;
+    static constexpr bool sameSuit = true;
+    static constexpr EmptyColumnRule emptyColumn = KINGS_ONLY;
+};
+
+struct SeahavenRules { // ten columns of five, two cards in the free cells
+    static constexpr int columns = 10;
+    static constexpr int freeCells = 4;
+    static constexpr int dealtToCells = 2;
+    static constexpr bool sameSuit = true;
+    static constexpr EmptyColumnRule emptyColumn = KINGS_ONLY;
+};
+
+//------------------------------------------------------------------------------
+
+template<class Rules>
+class BasicGameState {
+public:
+    static constexpr int columnCount = Rules::columns;
+    static constexpr int cellCount = Rules::freeCells;
+    static constexpr int cellBase = columnCount; // first free cell location
+    static constexpr int homeBase = cellBase + cellCount; // first home location (one per suit)
+    static constexpr int columnCapacity = (NUMBER_OF_CARDS - Rules::dealtToCells + columnCount - 1) / columnCount + KING; // dealt cards plus a run from queen down to ace
+    static constexpr int slots = columnCount * columnCapacity + cellCount + 1; // column rows, free cells and home
+    BasicGameState();
+    static BasicGameState deal(int GI);
+    static BasicGameState deal(const uint8_t *order);
+    static void dealOrder(int GI, uint8_t *order);
+    static int RNG(int seed);
+    int columnSize(int col) const;
+    uint8_t columnCard(int col, int row) const;
+    uint8_t topCard(int col) const;
+    uint8_t freeCell(int cell) const;
+    int homeRank(int suit) const;
+    int cardsAtHome() const;
+    int emptyColumns() const;
+    int emptyFreeCells() const;
+    int runLength(int col) const;
+    int capacity(bool toEmptyColumn, int freeCells = Rules::freeCells) const;
+    static bool canStack(uint8_t card, uint8_t onto);
+    static bool canFill(uint8_t card);
+    uint8_t baseCard(const Move &m) const;
+    bool isLegal(const Move &m) const;
+    void apply(const Move &m);
+    void revert(const Move &m);
+    bool isWon() const;
+    bool isSorted() const;
+    uint64_t hash() const;
+    uint64_t rehash() const;
+    BasicGameState canonical(bool swapSuits = false) const;
+    uint64_t canonicalKey(bool swapSuits = false) const;
+private:
+    uint8_t columns[columnCount][columnCapacity]; // cards in each column from the bottom up
+    uint8_t sizes[columnCount]; // amount of cards in each column
+    uint8_t cells[cellCount]; // free cells
+    uint8_t homes[NUMBER_OF_HOMES]; // amount of cards at home for each suit
+    uint64_t key; // zobrist hash, updated by every move
+};
+
+// built in gameState.cpp only
+extern template class BasicGameState<FreeCellRules>;
+extern template class BasicGameState<BakersGameRules>;
+extern template class BasicGameState<EightOffRules>;
+extern template class BasicGameState<SeahavenRules>;
+
+typedef BasicGameState<FreeCellRules> GameState; // the game the app plays, the macros above describe its table
+static_assert(GameState::columnCount == NUMBER_OF_COLUMNS && GameState::cellCount == NUMBER_OF_FREECELLS, "FreeCell table");
+static_assert(GameState::homeBase == HOME_BASE && GameState::columnCapacity == COLUMN_CAPACITY, "FreeCell locations");
+
+#endif /* gameState_hpp */
@@ -0,0 +1,83 @@
+
+
+#include "hintWorker.hpp"
+#include "moveGenerator.hpp"
+
+//--------------------------------------------------------------
+HintWorker::HintWorker() : pending(false), quit(false), cancel(false) {
+    thread = std::thread(&HintWorker::work, this);
+}
+
+//--------------------------------------------------------------
+HintWorker::~HintWorker() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+        cancel = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+//--------------------------------------------------------------
+void HintWorker::analyse(const GameState &s) { // replaces whatever the worker was doing
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job = s;
+        pending = true;
+        cancel = true;
+    }
+    wake.notify_one();
+}
+
+//--------------------------------------------------------------
+void HintWorker::cancelJob() { // the position is known already, nothing to analyse
+    std::lock_guard<std::mutex> guard(lock);
+    pending = false;
+    cancel = true;
+}
+
+//--------------------------------------------------------------
+std::shared_ptr<const HintAnswer> HintWorker::getAnswer() const { // may belong to an earlier position, compare the hash
+    return std::atomic_load(&answer);
+}
+
+//--------------------------------------------------------------
+void HintWorker::work() {
+    while(true) {
+        GameState s;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this]() { return pending || quit; });
+            if(quit) return;
+            s = job;
+            pending = false;
+            cancel = false; // set again by the next analyse
+        }
+        std::shared_ptr<HintAnswer> a = std::make_shared<HintAnswer>();
+        a->position = s.hash();
+        SolveResult solution = solve(s, HINT_BUDGET, &cancel, ANALYSIS_TIME); // same search Deck::hint used to run on a click
+        a->progress = PROGRESS;
+        if(solution.status != SOLVED && !cancel) a->progress = findProgress(s, PROGRESS_BUDGET, &cancel, ANALYSIS_TIME); // no win in sight, is it stuck
+        if(cancel) continue; // the position changed meanwhile
+        a->status = solution.status;
+        a->hasMove = false;
+        if(solution.status == SOLVED && solution.moves.size() > 0) {
+            a->solution = solution.moves;
+            a->move = solution.moves[0];
+            a->hasMove = true;
+        } else if(solution.status == GAVE_UP) { // suggest the most wanted kind of move
+            MoveList list;
+            generateMoves(s, list);
+            int best = -1;
+            for(int i = 0; i < list.size; i++) {
+                if(best == -1 || list.kinds[i] < list.kinds[best]) best = i;
+            }
+            if(best != -1) {
+                a->move = list.moves[best];
+                a->hasMove = true;
+            }
+        }
+        std::atomic_store(&answer, std::shared_ptr<const HintAnswer>(a));
+    }
+}
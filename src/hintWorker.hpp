@@ -0,0 +1,51 @@
+
+
+#ifndef hintWorker_hpp
+#define hintWorker_hpp
+
+#include "gameState.hpp"
+#include "solver.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define ANALYSIS_TIME 1000 // milliseconds each search of a position may take, the hint and the dead end check
+#define PROGRESS_BUDGET 200000 // positions the dead end check may visit
+
+//------------------------------------------------------------------------------
+
+// what the worker found for one position, never changed after it is published
+struct HintAnswer {
+    uint64_t position; // hash of the analysed position
+    SolveStatus status;
+    std::vector<Move> solution; // from the position to the end when SOLVED
+    bool hasMove; // is there a move to show
+    Move move; // first move of the solution, or of the most wanted kind when the search gave up
+    ProgressStatus progress; // can any card still go home, only checked when the position wasn't solved
+};
+
+// analyses positions on its own thread so pressing HINT only reads the answer and dead ends show up
+// without asking, a new position cancels the search for the old one and answers replace each other atomically
+class HintWorker {
+public:
+    HintWorker();
+    ~HintWorker();
+    void analyse(const GameState &s);
+    void cancelJob();
+    std::shared_ptr<const HintAnswer> getAnswer() const;
+private:
+    std::thread thread;
+    std::mutex lock; // guards job, pending and quit
+    std::condition_variable wake;
+    GameState job; // snapshot of the position to analyse
+    bool pending; // job waits to be taken
+    bool quit;
+    std::atomic<bool> cancel; // stops the running search
+    std::shared_ptr<const HintAnswer> answer; // latest answer, only touched through atomic_load and atomic_store
+    void work();
+};
+
+#endif /* hintWorker_hpp */
@@ -0,0 +1,58 @@
+
+
+#include "hitGrid.hpp"
+
+//--------------------------------------------------------------
+HitGrid::HitGrid() : columnStep(1), spacing(1), homeStep(1), freeCellStep(1) {}
+
+//--------------------------------------------------------------
+void HitGrid::setColumns(const ofVec2f &first, float step, float s) {
+    columns = first;
+    columnStep = step;
+    spacing = s;
+}
+
+//--------------------------------------------------------------
+void HitGrid::setHomes(const ofVec2f &first, float step) {
+    homes = first;
+    homeStep = step;
+}
+
+//--------------------------------------------------------------
+void HitGrid::setFreeCells(const ofVec2f &first, float step) {
+    freeCells = first;
+    freeCellStep = step;
+}
+
+//--------------------------------------------------------------
+void HitGrid::setCardSize(const ofVec2f &s) {
+    size = s;
+}
+
+//--------------------------------------------------------------
+Hit HitGrid::find(float x, float y, const GameState &state) const { // edges count as inside like Deck::clicked did
+    Hit h = {HIT_NOTHING, -1, -1};
+    if(y >= homes.y && y <= homes.y + size.y) { // top row
+        int i = bucket(x, homes.x, homeStep, size.x, NUMBER_OF_HOMES);
+        if(i != -1) return {HIT_HOME, i, -1};
+    }
+    if(y >= freeCells.y && y <= freeCells.y + size.y) {
+        int i = bucket(x, freeCells.x, freeCellStep, size.x, NUMBER_OF_FREECELLS);
+        if(i != -1) return {HIT_FREECELL, i, -1};
+    }
+    int col = bucket(x, columns.x, columnStep, size.x, NUMBER_OF_COLUMNS);
+    if(col == -1 || y < columns.y) return h;
+    int n = state.columnSize(col);
+    int row = (int)((y - columns.y) / spacing); // every card shows a strip of spacing pixels
+    if(row > n - 1) row = n - 1; // the top card shows whole
+    if(y > columns.y + (row < 0 ? 0 : row) * spacing + size.y) return h; // below the column
+    return {HIT_COLUMN, col, row};
+}
+
+//--------------------------------------------------------------
+int HitGrid::bucket(float x, float first, float step, float width, int count) { // pile under x or -1 in a gap
+    if(x < first) return -1;
+    int i = (int)((x - first) / step);
+    if(i >= count || x > first + i * step + width) return -1;
+    return i;
+}
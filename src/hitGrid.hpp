@@ -0,0 +1,44 @@
+
+
+#ifndef hitGrid_hpp
+#define hitGrid_hpp
+
+#include "ofMain.h"
+#include "gameState.hpp"
+
+//------------------------------------------------------------------------------
+
+enum HitKind {HIT_NOTHING, HIT_COLUMN, HIT_FREECELL, HIT_HOME};
+
+// what a point of the table is over
+struct Hit {
+    HitKind kind;
+    int index; // column, free cell or home pile
+    int row; // card of the column counted from the bottom, -1 over an empty column
+};
+
+//------------------------------------------------------------------------------
+
+// the table layout as evenly spaced buckets, a point finds its pile with one division
+// and its card in a column with one more using the row spacing
+class HitGrid {
+public:
+    HitGrid();
+    void setColumns(const ofVec2f &first, float step, float spacing);
+    void setHomes(const ofVec2f &first, float step);
+    void setFreeCells(const ofVec2f &first, float step);
+    void setCardSize(const ofVec2f &s);
+    Hit find(float x, float y, const GameState &state) const;
+private:
+    ofVec2f columns; // top left of the first column
+    float columnStep; // distance between two columns
+    float spacing; // distance between two rows of a column
+    ofVec2f homes; // top left of the first home
+    float homeStep;
+    ofVec2f freeCells; // top left of the first free cell
+    float freeCellStep;
+    ofVec2f size; // card size
+    static int bucket(float x, float first, float step, float width, int count);
+};
+
+#endif /* hitGrid_hpp */
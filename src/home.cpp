@@ -4,13 +4,12 @@
 #include "pile.hpp"
 
 //--------------------------------------------------------------
-Home::Home(ofVec2f pos, ofVec2f s, bool top) : Pile(pos, s, top) {
+Home::Home(ofVec2f pos, ofVec2f s, bool top, const CardAtlas &a) : Pile(pos, s, top), atlas(&a) {
 //    position.set(pos.x, pos.y);
     setPosition(pos);
     setSize(s);
     setOnTop(top);
     currentRank = 0;
-    homeImage.load("home.png");
 }
 
 
@@ -22,7 +21,7 @@ void Home::draw() {
     ofDrawRectangle(getPosition().x, getPosition().y, getSize().x, getSize().y);
     ofFill();
     ofSetColor(0,50); // freeCell
-    homeImage.draw(getPosition().x, getPosition().y, getSize().x, getSize().y);
+    atlas->draw(ATLAS_HOME, getPosition().x, getPosition().y, getSize().x, getSize().y);
     ofPopStyle();
 }
 
@@ -0,0 +1,71 @@
+#include "leaderboard.hpp"
+
+// a key is the value turned so that better is smaller in the high half and the record index in the low half,
+// so ties keep the order the games were played in
+
+//--------------------------------------------------------------
+void Leaderboard::clear() {
+    for(int i = 0; i < 3; i++) trees[i].clear();
+    deals.clear();
+}
+
+//--------------------------------------------------------------
+void Leaderboard::add(const ScoreRecord &r, int index) {
+    trees[BY_SCORE].insert(order(BY_SCORE, r.score) + index);
+    trees[BY_SECONDS].insert(order(BY_SECONDS, r.seconds) + index);
+    trees[BY_MOVES].insert(order(BY_MOVES, r.moves) + index);
+    if(r.deal >= 0) deals[r.deal].insert(order(BY_SCORE, r.score) + index);
+}
+
+//--------------------------------------------------------------
+int64_t Leaderboard::size() const {
+    return trees[BY_SCORE].size();
+}
+
+//--------------------------------------------------------------
+int64_t Leaderboard::place(LeaderboardKey by, int value) const { // 1 is the best, ties share the better place
+    return trees[by].countLess(order(by, value)) + 1;
+}
+
+//--------------------------------------------------------------
+double Leaderboard::percentile(LeaderboardKey by, int value) const { // share of games the value is at least as good as
+    int64_t n = size();
+    if(n == 0) return 100;
+    return 100.0 * (n - trees[by].countLess(order(by, value))) / n;
+}
+
+//--------------------------------------------------------------
+std::vector<int> Leaderboard::top(LeaderboardKey by, int k) const { // record indices of the k best games
+    return top(trees[by], k);
+}
+
+//--------------------------------------------------------------
+int64_t Leaderboard::dealSize(int deal) const {
+    auto it = deals.find(deal);
+    return it == deals.end() ? 0 : it->second.size();
+}
+
+//--------------------------------------------------------------
+int64_t Leaderboard::dealPlace(int deal, int score) const {
+    auto it = deals.find(deal);
+    return it == deals.end() ? 1 : it->second.countLess(order(BY_SCORE, score)) + 1;
+}
+
+//--------------------------------------------------------------
+std::vector<int> Leaderboard::dealTop(int deal, int k) const {
+    auto it = deals.find(deal);
+    return it == deals.end() ? std::vector<int>() : top(it->second, k);
+}
+
+//--------------------------------------------------------------
+int64_t Leaderboard::order(LeaderboardKey by, int value) { // high half of a key, higher scores come first
+    int64_t v = by == BY_SCORE ? -(int64_t)value : value;
+    return v * ((int64_t)1 << 32);
+}
+
+//--------------------------------------------------------------
+std::vector<int> Leaderboard::top(const RankTree &tree, int k) {
+    std::vector<int> indices;
+    for(int64_t i = 0; i < k && i < tree.size(); i++) indices.push_back((int)(tree.kth(i) & 0xFFFFFFFF));
+    return indices;
+}
@@ -0,0 +1,33 @@
+#ifndef leaderboard_hpp
+#define leaderboard_hpp
+
+#include "rankTree.hpp"
+#include "scoreRecord.hpp"
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+enum LeaderboardKey {BY_SCORE, BY_SECONDS, BY_MOVES};
+
+// every game of the score journal sorted by score, time and moves, and by score within each deal,
+// games are referred to by their index in the journal's records
+class Leaderboard {
+public:
+    void clear();
+    void add(const ScoreRecord &r, int index);
+    int64_t size() const;
+    int64_t place(LeaderboardKey by, int value) const;
+    double percentile(LeaderboardKey by, int value) const;
+    std::vector<int> top(LeaderboardKey by, int k) const;
+    int64_t dealSize(int deal) const;
+    int64_t dealPlace(int deal, int score) const;
+    std::vector<int> dealTop(int deal, int k) const;
+private:
+    RankTree trees[3]; // one per LeaderboardKey
+    std::unordered_map<int, RankTree> deals; // by score
+    static int64_t order(LeaderboardKey by, int value);
+    static std::vector<int> top(const RankTree &tree, int k);
+};
+
+#endif /* leaderboard_hpp */
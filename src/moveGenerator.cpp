@@ -0,0 +1,86 @@
+
+
+#include "moveGenerator.hpp"
+
+//--------------------------------------------------------------
+static void addMove(MoveList &list, MoveKind kind, int from, int to, int count) {
+    Move &m = list.moves[list.size];
+    m.from = from;
+    m.to = to;
+    m.count = count;
+    list.kinds[list.size++] = kind;
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+void generateMoves(const BasicGameState<Rules> &s, MoveList &list) {
+    typedef BasicGameState<Rules> State;
+    list.size = 0;
+    uint8_t tops[State::columnCount]; // top card of each column
+    int runs[State::columnCount]; // ordered cards at the top of each column
+    int emptyReg = -1; // first empty column
+    int emptyFc = -1; // first empty free cell
+    for(int i = 0; i < State::columnCount; i++) {
+        tops[i] = s.topCard(i);
+        runs[i] = s.runLength(i);
+        if(tops[i] == NO_CARD && emptyReg == -1) emptyReg = i;
+    }
+    for(int i = 0; i < State::cellCount; i++) if(s.freeCell(i) == NO_CARD && emptyFc == -1) emptyFc = i;
+    int toCard = s.capacity(0); // cards that can move onto another card
+    int toReg = s.capacity(1); // cards that can move to an empty column
+    for(int i = 0; i < State::columnCount; i++) { // moves from columns
+        if(tops[i] == NO_CARD) continue;
+        int suit = cardSuit(tops[i]);
+        if(s.homeRank(suit) == cardRank(tops[i])) addMove(list, CARD_TO_HOME, i, State::homeBase + suit, 1);
+        int movable = (runs[i] < toCard) ? runs[i] : toCard;
+        for(int j = 0; j < State::columnCount; j++) {
+            if(j == i || tops[j] == NO_CARD) continue;
+            // ranks grow by one down the run so only one card of it can go on the target
+            int count = cardRank(tops[j]) - cardRank(tops[i]);
+            if(count >= 1 && count <= movable && State::canStack(s.columnCard(i, s.columnSize(i) - count), tops[j]))
+                addMove(list, CARD_TO_CARD, i, j, count);
+        }
+        if(emptyReg != -1) { // biggest part of the run first
+            int count = (runs[i] < toReg) ? runs[i] : toReg;
+            for(; count >= 1; count--) {
+                if(count != s.columnSize(i) && State::canFill(s.columnCard(i, s.columnSize(i) - count))) addMove(list, CARD_TO_REG, i, emptyReg, count);
+            }
+        }
+        if(emptyFc != -1) addMove(list, CARD_TO_FC, i, State::cellBase + emptyFc, 1);
+    }
+    for(int i = 0; i < State::cellCount; i++) { // moves from free cells
+        uint8_t card = s.freeCell(i);
+        if(card == NO_CARD) continue;
+        if(s.homeRank(cardSuit(card)) == cardRank(card)) addMove(list, FC_TO_HOME, State::cellBase + i, State::homeBase + cardSuit(card), 1);
+        for(int j = 0; j < State::columnCount; j++) {
+            if(tops[j] != NO_CARD && State::canStack(card, tops[j])) addMove(list, FC_TO_CARD, State::cellBase + i, j, 1);
+        }
+        if(emptyReg != -1 && State::canFill(card)) addMove(list, FC_TO_REG, State::cellBase + i, emptyReg, 1);
+    }
+}
+
+//--------------------------------------------------------------
+template<class Rules>
+bool nextHomeMove(const BasicGameState<Rules> &s, Move &m) {
+    MoveList list;
+    generateMoves(s, list);
+    int best = -1;
+    for(int i = 0; i < list.size; i++) { // find smallest card that can go home
+        if(list.moves[i].to < BasicGameState<Rules>::homeBase) continue;
+        if(best == -1 || cardRank(s.baseCard(list.moves[i])) < cardRank(s.baseCard(list.moves[best]))) best = i;
+    }
+    if(best == -1) return false; // nothing more goes home
+    m = list.moves[best];
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+template void generateMoves(const BasicGameState<FreeCellRules> &s, MoveList &list);
+template void generateMoves(const BasicGameState<BakersGameRules> &s, MoveList &list);
+template void generateMoves(const BasicGameState<EightOffRules> &s, MoveList &list);
+template void generateMoves(const BasicGameState<SeahavenRules> &s, MoveList &list);
+template bool nextHomeMove(const BasicGameState<FreeCellRules> &s, Move &m);
+template bool nextHomeMove(const BasicGameState<BakersGameRules> &s, Move &m);
+template bool nextHomeMove(const BasicGameState<EightOffRules> &s, Move &m);
+template bool nextHomeMove(const BasicGameState<SeahavenRules> &s, Move &m);
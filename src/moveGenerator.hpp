@@ -0,0 +1,42 @@
+
+
+#ifndef moveGenerator_hpp
+#define moveGenerator_hpp
+
+#include "gameState.hpp"
+
+#define MAX_MOVES 256 // more than any position can have
+
+//------------------------------------------------------------------------------
+
+// kinds of moves in the order hint prefers them
+enum MoveKind {
+    CARD_TO_HOME,
+    FC_TO_HOME,
+    FC_TO_CARD,
+    CARD_TO_CARD,
+    CARD_TO_REG,
+    FC_TO_REG,
+    CARD_TO_FC
+};
+
+//------------------------------------------------------------------------------
+
+struct MoveList {
+    Move moves[MAX_MOVES]; // legal moves
+    uint8_t kinds[MAX_MOVES]; // MoveKind of each move
+    int size; // amount of moves found
+};
+
+// lists every legal move of the position in one pass over the columns and free cells
+// moves that only swap equivalent places are left out: the first empty free cell and the first
+// empty column stand for all of them, whole columns are not moved to an empty column
+// and cards don't move between free cells, built for each variant in moveGenerator.cpp
+template<class Rules>
+void generateMoves(const BasicGameState<Rules> &s, MoveList &list);
+
+// the move sending the lowest card home, false when no card can go
+template<class Rules>
+bool nextHomeMove(const BasicGameState<Rules> &s, Move &m);
+
+#endif /* moveGenerator_hpp */
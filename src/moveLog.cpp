@@ -0,0 +1,86 @@
+#include "moveLog.hpp"
+
+//--------------------------------------------------------------
+MoveLog::MoveLog() : cursor(0) {}
+
+//--------------------------------------------------------------
+void MoveLog::reset(const GameState &start) { // new game, forget everything
+    entries.clear();
+    snapshots.clear();
+    snapshots.push_back(start);
+    cursor = 0;
+}
+
+//--------------------------------------------------------------
+void MoveLog::push(const Move &m, const GameState &after) { // a new move drops whatever could be redone
+    entries.resize(cursor);
+    snapshots.resize(cursor / SNAPSHOT_INTERVAL + 1); // later positions belong to the dropped moves
+    LogEntry e;
+    e.from = m.from;
+    e.to = m.to;
+    e.count = m.count;
+    e.homeDelta = m.to >= HOME_BASE ? 1 : 0;
+    entries.push_back(e);
+    cursor++;
+    if(cursor % SNAPSHOT_INTERVAL == 0) snapshots.push_back(after);
+}
+
+//--------------------------------------------------------------
+bool MoveLog::canUndo() const {
+    return cursor > 0;
+}
+
+//--------------------------------------------------------------
+bool MoveLog::canRedo() const {
+    return cursor < entries.size();
+}
+
+//--------------------------------------------------------------
+LogEntry MoveLog::undo(GameState &s) { // check canUndo first
+    const LogEntry &e = entries[--cursor];
+    s.revert(toMove(e));
+    return e;
+}
+
+//--------------------------------------------------------------
+LogEntry MoveLog::redo(GameState &s) { // check canRedo first
+    const LogEntry &e = entries[cursor++];
+    s.apply(toMove(e));
+    return e;
+}
+
+//--------------------------------------------------------------
+GameState MoveLog::at(int n) const { // position after the first n moves, replays less than SNAPSHOT_INTERVAL of them
+    GameState s = snapshots[n / SNAPSHOT_INTERVAL];
+    for(int i = n / SNAPSHOT_INTERVAL * SNAPSHOT_INTERVAL; i < n; i++) s.apply(toMove(entries[i]));
+    return s;
+}
+
+//--------------------------------------------------------------
+int MoveLog::size() const {
+    return entries.size();
+}
+
+//--------------------------------------------------------------
+int MoveLog::getCursor() const {
+    return cursor;
+}
+
+//--------------------------------------------------------------
+void MoveLog::setCursor(int n) { // pair with at(n) to jump
+    cursor = n;
+}
+
+//--------------------------------------------------------------
+const LogEntry& MoveLog::entry(int i) const {
+    return entries[i];
+}
+
+//--------------------------------------------------------------
+Move MoveLog::toMove(const LogEntry &e) {
+    Move m;
+    m.from = e.from;
+    m.to = e.to;
+    m.count = e.count;
+    return m;
+}
@@ -0,0 +1,44 @@
+#ifndef moveLog_hpp
+#define moveLog_hpp
+
+#include "gameState.hpp"
+#include <vector>
+
+#define SNAPSHOT_INTERVAL 32 // moves between two stored positions
+
+//------------------------------------------------------------------------------
+
+// one played move, four bytes
+struct LogEntry {
+    uint8_t from; // column or FREECELL_BASE + cell
+    uint8_t to; // column, FREECELL_BASE + cell or HOME_BASE + suit
+    uint8_t count; // number of cards moved
+    int8_t homeDelta; // cards the move sent home
+};
+
+//------------------------------------------------------------------------------
+
+// every move of a game with a cursor, undo and redo revert or apply one entry,
+// a position every SNAPSHOT_INTERVAL moves lets any point of the game be rebuilt quickly
+class MoveLog {
+public:
+    MoveLog();
+    void reset(const GameState &start);
+    void push(const Move &m, const GameState &after);
+    bool canUndo() const;
+    bool canRedo() const;
+    LogEntry undo(GameState &s);
+    LogEntry redo(GameState &s);
+    GameState at(int n) const;
+    int size() const;
+    int getCursor() const;
+    void setCursor(int n);
+    const LogEntry& entry(int i) const;
+    static Move toMove(const LogEntry &e);
+private:
+    std::vector<LogEntry> entries; // moves in the order they were played, redo tail after the cursor
+    std::vector<GameState> snapshots; // position after i * SNAPSHOT_INTERVAL moves, the first one is the deal
+    int cursor; // moves currently applied
+};
+
+#endif /* moveLog_hpp */
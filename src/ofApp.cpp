@@ -1,20 +1,78 @@
 #include "ofApp.h"
 #include "deck.hpp"
 
+#define ACTIVE_FPS 60 // frame rate while the player is doing something
+#define IDLE_FPS 4 // frame rate while nothing happens, enough for the clock
+#define ACTIVE_TIME 1000 // milliseconds of full frame rate after the last input
+#define AUTOCOMPLETE_DELAY 500 // milliseconds the autocomplete dialog ignores clicks
+#define IMPORTED_GAME 0xFFFFFFFF00000000ull // game id of the first score imported from scoreTable.xml
+#define DEAL_TOP 10 // best games of the deal listed next to the finished dialog
+#define JUMP_MOVES 10 // moves page up and page down undo or redo at once
+
+// bit of each button in hover, same order as in hovered
+enum {HOVER_UNDO = 1, HOVER_HINT = 2, HOVER_RESET = 4, HOVER_NEW = 8, HOVER_REDO = 16, HOVER_YES = 32, HOVER_NO = 64, HOVER_NEW_GAME = 128};
+
 //--------------------------------------------------------------
 void ofApp::setup() {
     d.newGame(); // set up a new random game
-    timer = 0;
+    autocompleteSince = 0;
     score = 0;
+    recorded = false;
+    journal.open(ofToDataPath("scores.journal"));
+    if(journal.getRecords().empty()) importScores(); // first start with the journal
+    for(int i = 0; i < journal.getRecords().size(); i++) board.add(journal.getRecords()[i], i);
+    frame.allocate(ofGetWidth(), ofGetHeight(), GL_RGB); // opaque, so translucent overlays don't leak through
+    idle = false;
+    hover = hovered(ofGetMouseX(), ofGetMouseY());
+    wake();
+}
+
+//--------------------------------------------------------------
+void ofApp::exit(){
+    journal.close(); // syncs the last scores
+    profiler.save(ofToDataPath("profile.csv")); // every timed call of the session
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+    profiler.beginFrame();
+    uint64_t now = ofGetSystemTimeMillis();
+    if(d.update()) redraw = true; // clock ticked, doesn't count as input
+    if(!d.getAutocomplete()) autocompleteSince = 0;
+    else if(autocompleteSince == 0) autocompleteSince = now; // dialog just appeared
+    bool quiet = now - lastChange > ACTIVE_TIME;
+    if(quiet != idle) { // slow down when nobody plays, speed up on the first input
+        idle = quiet;
+        ofSetFrameRate(idle ? IDLE_FPS : ACTIVE_FPS);
+    }
 }
 
 //--------------------------------------------------------------
 void ofApp::draw(){
+    if(redraw) { // otherwise the last frame is shown again
+        frame.begin();
+        ofClear(ofGetBackgroundColor());
+        drawTable();
+        frame.end();
+        redraw = false;
+    }
+    ofPushStyle();
+    ofSetColor(255);
+    frame.draw(0, 0);
+    ofPopStyle();
+    profiler.draw(ofGetWidth() - 480, 60); // over the cached frame so it never ends up in it
+    profiler.endFrame();
+}
+
+//--------------------------------------------------------------
+void ofApp::drawTable(){
     d.draw(); // draw game
     ofPushStyle();
     drawTopBar(); // draw top bar
     if(!d.getEnough()) drawDialog("NOT ENOUGH SPACE TO MOVE", ofGetWidth()/2-150, ofGetHeight()-60, 300, 50); // draw not enough
     if(d.getNoMore()) drawDialog("NO MORE POSSIBLE MOVES", ofGetWidth()/2-150, ofGetHeight()-60, 300, 50); // draw no more moves
+    else if(d.getDeadEnd() == DEAD_END_STUCK) drawDialog("NO PROGRESS POSSIBLE", ofGetWidth()/2-150, ofGetHeight()-60, 300, 50); // found in the background
+    else if(d.getDeadEnd() == DEAD_END_UNWINNABLE) drawDialog("THIS GAME CAN'T BE WON", ofGetWidth()/2-150, ofGetHeight()-60, 300, 50);
     if(d.getAutocomplete()) drawAutocomplete(); // draw autocomplete dialog window
     if(d.getFinished()) drawFinished(); // draw game complete dialog window
     ofPopStyle();
@@ -26,10 +84,12 @@ void ofApp::drawTopBar(){
     ofDrawRectangle(0, 0, ofGetWidth(), 50); // background
     ofSetColor(0);
     ofDrawLine(0, 50, ofGetWidth(), 50); // border
-    un->draw(); // undo
-    hi->draw(); // hint
-    re->draw(); // reset
-    ng->draw(); // new game
+    un->draw(hover & HOVER_UNDO); // undo
+    hi->draw(hover & HOVER_HINT); // hint
+    re->draw(hover & HOVER_RESET); // reset
+    ng->draw(hover & HOVER_NEW); // new game
+    rd->draw(hover & HOVER_REDO); // redo
+    ofDrawBitmapString("LEVEL:" + d.getLevel(), 520, 30); // difficulty of new games, keys 0 - 4
     ofDrawBitmapString("SCORE:" + ofToString(d.getScore()), ofGetWidth() - 300, 30); // current score
     ofDrawBitmapString("MOVES:" + ofToString(d.getMoves()), ofGetWidth() - 200, 30); // current moves
     ofDrawBitmapString(d.getTime(), ofGetWidth() - 100, 30); // current time
@@ -52,10 +112,9 @@ void ofApp::drawDialog(string t, float x, float y, int w, int h){
 
 //--------------------------------------------------------------
 void ofApp::drawAutocomplete(){
-    timer++; // prevents accidental clicks
     drawDialog("AUTOCOMPLETE ?", (ofGetWidth()/2) - 200, (ofGetHeight()/2) - 150, 400, 100); // draw basic dialog window
-    yes->draw(); // draw yes button
-    no->draw(); // draw no button
+    yes->draw(hover & HOVER_YES); // draw yes button
+    no->draw(hover & HOVER_NO); // draw no button
 }
 
 //--------------------------------------------------------------
@@ -68,7 +127,14 @@ void ofApp::drawFinished(){
     drawScore(bScore, "YOUR SCORE:" + ofToString(score), "BEST SCORE:" + ofToString(bestScore), yourX, bestX, scoreY);
     drawScore(bMoves, "YOUR MOVES:" + ofToString(d.getMoves()), "BEST MOVES:" + ofToString(bestMoves), yourX, bestX, scoreY + 20);
     drawScore(bTime, "YOUR " + d.getTime(), "BEST " + bestTime, yourX, bestX, scoreY + 40);
-    newGame->draw(); // draw start a new game button
+    ofDrawBitmapString(placed, (ofGetWidth() - placed.length() * 8) / 2, scoreY + 60); // rank among all games, centered
+    newGame->draw(hover & HOVER_NEW_GAME); // draw start a new game button
+    if(dealTop.empty()) return; // deal unknown
+    float topX = (ofGetWidth()/2) + 220; // right of the dialog
+    float topY = (ofGetHeight()/2) - 150;
+    drawDialog("TOP " + ofToString(DEAL_TOP) + " ON THIS DEAL", topX, topY, 240, 230);
+    for(int i = 0; i < dealTop.size(); i++) ofDrawBitmapString(dealTop[i], topX + 20, topY + 55 + i * 15); // best first
+    ofDrawBitmapString(percent, topX + 20, topY + 215); // share of all games
 }
 
 //--------------------------------------------------------------
@@ -86,59 +152,146 @@ void ofApp::drawScore(bool c, const string s1, const string s2, const float x1,
 
 //--------------------------------------------------------------
 void ofApp::mousePressed(int x, int y, int button){
-    d.mousePressed(); // deals with the game [cards and piles]
-    if(un->getHover()) un->mousePressed(&Deck::undo, d); // undo button
-    if(hi->getHover()) hi->mousePressed(&Deck::hint, d); // hint button
-    if(re->getHover()) re->mousePressed(&Deck::refresh, d); // restart button
-    if(ng->getHover()) ng->mousePressed(&Deck::newGame, d); // new game button
-    if(d.getAutocomplete() && timer >= 30) { // if game is solved for half a second
-        if(no->getHover()) no->mousePressed(&Deck::skipAutocomplete, d); // don't autocomplete button
-        if(yes->getHover()) yes->mousePressed(&Deck::doAutocomplete, d); // autocomplete button
-        timer = 0; // reset timer
+    d.mousePressed(x, y); // deals with the game [cards and piles]
+    if(un->contains(x, y)) un->mousePressed(&Deck::undo, d); // undo button
+    if(hi->contains(x, y)) hi->mousePressed(&Deck::hint, d); // hint button
+    if(re->contains(x, y)) re->mousePressed(&Deck::refresh, d); // restart button
+    if(ng->contains(x, y)) ng->mousePressed(&Deck::newGame, d); // new game button
+    if(rd->contains(x, y)) rd->mousePressed(&Deck::redo, d); // redo button
+    if(d.getAutocomplete() && ofGetSystemTimeMillis() - autocompleteSince >= AUTOCOMPLETE_DELAY) { // if game is solved for half a second
+        if(no->contains(x, y)) no->mousePressed(&Deck::skipAutocomplete, d); // don't autocomplete button
+        if(yes->contains(x, y)) yes->mousePressed(&Deck::doAutocomplete, d); // autocomplete button
+        autocompleteSince = ofGetSystemTimeMillis(); // reset timer
     }
     if(d.getFinished()) { // if the game is finished
         score = d.getScore() + 1000000 / d.getSeconds();; // calculate final score
-        saveScore(); // save score to xml file
-        getBScore(); // get best score from xml and compare it to this game score
-        if(newGame->getHover()) newGame->mousePressed(&Deck::newGame, d); // new game button
+        if(!recorded) { // once per game, the dialog takes many clicks
+            d.saveReplay(score); // save the game for checking the score
+            saveScore(); // append score to the journal
+            getBScore(); // get best score from the journal and compare it to this game score
+            recorded = true;
+        }
+        if(newGame->contains(x, y)) newGame->mousePressed(&Deck::newGame, d); // new game button
+    }
+    if(!d.getFinished()) recorded = false; // next game gets its own replay
+    wake(); // any click can change the table or a dialog
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+    if(key == 'p') profiler.toggle(); // timing overlay
+    if(key == '0') d.setLevel(-1); // any deal
+    if(key >= '1' && key < '1' + DIFFICULTY_LEVELS) d.setLevel(key - '1'); // difficulty of the next new game
+    if(!d.getFinished() && !d.getAutocomplete()) { // walk through the move log like many undos or redos
+        if(key == OF_KEY_HOME) d.jumpTo(0); // back to the deal, everything stays to redo
+        if(key == OF_KEY_END) d.jumpTo(d.getLogSize()); // latest move
+        if(key == OF_KEY_PAGE_UP) d.jumpTo(max(0, d.getLogCursor() - JUMP_MOVES));
+        if(key == OF_KEY_PAGE_DOWN) d.jumpTo(min(d.getLogSize(), d.getLogCursor() + JUMP_MOVES));
+    }
+    wake();
+}
+
+//--------------------------------------------------------------
+void ofApp::mouseMoved(int x, int y){
+    int h = hovered(x, y);
+    if(h != hover) { // a button lights up or goes dark
+        hover = h;
+        wake();
     }
 }
 
+//--------------------------------------------------------------
+void ofApp::windowResized(int w, int h){
+    frame.allocate(w, h, GL_RGB);
+    wake();
+}
+
+//--------------------------------------------------------------
+void ofApp::wake(){ // draws the next frame and keeps the full frame rate for a while
+    redraw = true;
+    lastChange = ofGetSystemTimeMillis();
+}
+
+//--------------------------------------------------------------
+int ofApp::hovered(int x, int y){ // one bit for every button under the point
+    Button* buttons[] = {un.get(), hi.get(), re.get(), ng.get(), rd.get(), yes.get(), no.get(), newGame.get()};
+    int h = 0;
+    for(int i = 0; i < 8; i++) if(buttons[i]->contains(x, y)) h |= 1 << i;
+    return h;
+}
+
 //--------------------------------------------------------------
 void ofApp::saveScore(){
-    XML.loadFile("scoreTable.xml"); // load file
-    XML.addTag("entry"); // create new entry
-    XML.pushTag("entry", XML.getNumTags("entry") - 1); // push into newly created entry
-    XML.addValue("score", score); // save score
-    XML.addValue("seconds", d.getSeconds()); // save time in seconds
-    XML.addValue("time", d.getTime()); // save time as string
-    XML.addValue("moves", d.getMoves()); // save number of moves
-    XML.popTag(); // pop out of the entry
-    XML.saveFile("scoreTable.xml"); // save updated settings
+    ProfileScope scope(PROFILE_SAVE_SCORE);
+    ScoreRecord r;
+    r.game = d.getGameId(); // the journal ignores a game it already has
+    r.deal = d.getDeal();
+    r.score = score;
+    r.seconds = d.getSeconds();
+    r.moves = d.getMoves();
+    r.time = ofGetUnixTime();
+    if(journal.append(r)) board.add(r, journal.getRecords().size() - 1); // one small write, synced in the background
 }
 
 //--------------------------------------------------------------
-void ofApp::getBScore(){
-    emptyScores(); // prepare variables
-    XML.loadFile("scoreTable.xml"); // load file
+void ofApp::importScores(){
+    if(!XML.loadFile("scoreTable.xml")) return; // nothing to import
     for(int i = 0; i<XML.getNumTags("entry"); i++){ // for all entries
         XML.pushTag("entry", i); // push into each entry
-        if(XML.getValue("score", 0) > bestScore) bestScore = XML.getValue("score", 0); // find best score
-        if(XML.getValue("seconds", 0) < bestSeconds) {
-            bestSeconds  = XML.getValue("seconds", 0); // find best time in seconds
-            bestTime  = XML.getValue("time", ""); // find best time as string
-        }
-        if(XML.getValue("moves", 0) < bestMoves) bestMoves = XML.getValue("moves", 0); // find best moves
+        ScoreRecord r;
+        r.game = IMPORTED_GAME + i; // same id every time, importing twice adds nothing
+        r.deal = -1; // the table didn't keep deals
+        r.score = XML.getValue("score", 0);
+        r.seconds = XML.getValue("seconds", 0);
+        r.moves = XML.getValue("moves", 0);
+        r.time = 0;
+        journal.append(r);
         XML.popTag();
     }
+    journal.flush();
+}
+
+//--------------------------------------------------------------
+void ofApp::getBScore(){
+    ProfileScope scope(PROFILE_BEST_SCORE);
+    emptyScores(); // prepare variables
+    const ScoreStats &stats = journal.getStats(); // kept up to date by every append
+    if(stats.getRecords() > 0) {
+        bestScore = stats.getBestScore(); // find best score
+        bestSeconds = stats.getBestSeconds(); // find best time in seconds
+        bestTime = Deck::formatTime(bestSeconds); // find best time as string
+        bestMoves = stats.getBestMoves(); // find best moves
+    }
+    placed = "PLACED " + ordinal(board.place(BY_SCORE, score)) + " OF " + ofToString(board.size()); // among all games
+    if(board.dealSize(d.getDeal()) > 1) placed += ", " + ordinal(board.dealPlace(d.getDeal(), score)) + " OF " + ofToString(board.dealSize(d.getDeal())) + " ON THIS DEAL";
+    percent = "BEAT OR TIED " + ofToString(board.percentile(BY_SCORE, score), 0) + "% OF GAMES";
+    vector<int> best = board.dealTop(d.getDeal(), DEAL_TOP);
+    for(int i = 0; i < best.size(); i++) { // place, score, time and moves, this game marked
+        const ScoreRecord &r = journal.getRecords()[best[i]];
+        char line[64];
+        snprintf(line, sizeof(line), "%c%2d.%7d %3d:%02d %4dM", r.game == d.getGameId() ? '*' : ' ', i + 1, r.score, r.seconds / 60, r.seconds % 60, r.moves);
+        dealTop.push_back(line);
+    }
     if(bestScore <= score) bScore = true; // was this the best score?
     if(bestSeconds >= d.getSeconds()) bTime = true; // was this the best time?
     if(bestMoves >= d.getMoves()) bMoves = true; // were those the best moves?
 
 }
 
+//--------------------------------------------------------------
+string ofApp::ordinal(int64_t n){ // 1ST, 2ND, 3RD, 4TH ...
+    string suffix = "TH";
+    if(n % 100 < 11 || n % 100 > 13) {
+        if(n % 10 == 1) suffix = "ST";
+        if(n % 10 == 2) suffix = "ND";
+        if(n % 10 == 3) suffix = "RD";
+    }
+    return ofToString(n) + suffix;
+}
+
 //--------------------------------------------------------------
 void ofApp::emptyScores(){
+    dealTop.clear();
     bScore = false;
     bTime = false;
     bMoves = false;
@@ -4,35 +4,60 @@
 #include "deck.hpp"
 #include "button.hpp"
 #include "ofxXmlSettings.h"
+#include "scoreJournal.hpp"
+#include "leaderboard.hpp"
 
 class ofApp : public ofBaseApp {
 
 	public:
 		void setup();
+		void exit();
+		void update();
 		void draw();
+        void drawTable();
         void drawTopBar();
         void drawDialog(string t, float x, float y, int w, int h);
         void drawAutocomplete();
         void drawFinished();
         void drawArrow(const float & x, const float & y);
         void drawScore(bool c, const string s1, const string s2, const float x1, const float x2, const float y);
+		void keyPressed(int key);
 		void mousePressed(int x, int y, int button);
+		void mouseMoved(int x, int y);
+		void windowResized(int w, int h);
+        void wake();
+        int hovered(int x, int y);
         void saveScore();
+        void importScores();
         void getBScore();
         void emptyScores();
+        string ordinal(int64_t n);
         Deck d; // game
         //buttons
         unique_ptr<Button> un = make_unique<Button>("UNDO", 10, 10);
         unique_ptr<Button> hi = make_unique<Button>("HINT", 110, 10);
         unique_ptr<Button> re = make_unique<Button>("RESET", 210, 10);
         unique_ptr<Button> ng = make_unique<Button>("NEW GAME", 310, 10);
+        unique_ptr<Button> rd = make_unique<Button>("REDO", 410, 10);
         unique_ptr<Button> yes = make_unique<Button>("YES", (ofGetWidth()/2) - 150, (ofGetHeight()/2) - 100);
         unique_ptr<Button> no = make_unique<Button>("NO", (ofGetWidth()/2) + 50, (ofGetHeight()/2) - 100);
         unique_ptr<Button> newGame = make_unique<Button>("NEW GAME", (ofGetWidth()/2) - 50, (ofGetHeight()/2) + 20);
-        int timer; // fix for autocomplete
+        uint64_t autocompleteSince; // when the autocomplete dialog appeared or was last clicked, fix for accidental clicks
+        // redrawing
+        ofFbo frame; // last drawn frame, shown again while nothing changes
+        bool redraw; // does the frame need drawing
+        bool idle; // is the app running at the idle frame rate
+        uint64_t lastChange; // time of the last input
+        int hover; // buttons under the mouse, one bit each
         // scoring
-        ofxXmlSettings XML;
+        ofxXmlSettings XML; // old score table, only read once to fill the journal
+        ScoreJournal journal; // every finished game
+        Leaderboard board; // the journal's games in order
+        string placed; // where the finished game ranks
+        string percent; // share of all games the finished one is at least as good as
+        vector<string> dealTop; // best games of the deal, one line each
         int score;
+        bool recorded; // were the finished game's score and replay saved
         bool bScore;
         bool bTime;
         bool bMoves;
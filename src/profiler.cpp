@@ -0,0 +1,138 @@
+
+
+#include "profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+Profiler profiler;
+
+static std::atomic<uint64_t> allocated(0); // operator new calls since the start
+
+//--------------------------------------------------------------
+void* operator new(size_t size) { // every allocation of the game goes through here to be counted
+    allocated.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+//--------------------------------------------------------------
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+//--------------------------------------------------------------
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+//--------------------------------------------------------------
+Profiler::Profiler() : frame(0), frameAllocs(0), visible(false) {
+    for(int i = 0; i < PROFILE_SECTIONS; i++) counts[i] = 0;
+    history.reserve(PROFILE_HISTORY);
+    frameStart = std::chrono::steady_clock::now();
+}
+
+//--------------------------------------------------------------
+void Profiler::add(ProfileSection s, float micros, uint32_t a) {
+    int slot = counts[s]++ % PROFILE_WINDOW;
+    times[s][slot] = micros;
+    allocs[s][slot] = a;
+    if(history.size() < PROFILE_HISTORY) history.push_back({frame, (uint32_t)s, micros, a});
+}
+
+//--------------------------------------------------------------
+void Profiler::beginFrame() { // start of ofApp::update
+    frameStart = std::chrono::steady_clock::now();
+}
+
+//--------------------------------------------------------------
+void Profiler::endFrame() { // end of ofApp::draw
+    uint64_t now = allocations();
+    add(PROFILE_FRAME, std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - frameStart).count(), now - frameAllocs);
+    frameAllocs = now;
+    frame++;
+}
+
+//--------------------------------------------------------------
+float Profiler::percentile(ProfileSection s, float p, bool a) const { // of the latest PROFILE_WINDOW samples, 0 without any
+    int n = std::min(counts[s], (uint32_t)PROFILE_WINDOW);
+    if(n == 0) return 0;
+    float values[PROFILE_WINDOW]; // on the stack, the overlay mustn't add allocations of its own
+    for(int i = 0; i < n; i++) values[i] = a ? allocs[s][i] : times[s][i];
+    int k = std::min(n - 1, (int)(p / 100 * n));
+    std::nth_element(values, values + k, values + n);
+    return values[k];
+}
+
+//--------------------------------------------------------------
+bool Profiler::save(const std::string &path) const { // one line per sample
+    FILE *f = fopen(path.c_str(), "w");
+    if(!f) return false;
+    fprintf(f, "frame,section,microseconds,allocations\n");
+    for(int i = 0; i < history.size(); i++) {
+        const ProfileSample &s = history[i];
+        fprintf(f, "%u,%s,%.1f,%u\n", s.frame, name((ProfileSection)s.section), s.micros, s.allocs);
+    }
+    return fclose(f) == 0;
+}
+
+//--------------------------------------------------------------
+void Profiler::draw(float x, float y) const { // milliseconds of every section and allocations per call
+    if(!visible) return;
+    ofPushStyle();
+    ofFill();
+    ofSetColor(0, 0, 0, 180);
+    ofDrawRectangle(x, y, 470, 30 + PROFILE_SECTIONS * 15);
+    ofSetColor(255);
+    ofDrawBitmapString("section        p50ms   p90ms   p99ms   maxms  alloc50 allocmax", x + 5, y + 15);
+    char line[96];
+    for(int i = 0; i < PROFILE_SECTIONS; i++) {
+        ProfileSection s = (ProfileSection)i;
+        snprintf(line, sizeof(line), "%-12s %7.2f %7.2f %7.2f %7.2f %8.0f %8.0f", name(s), percentile(s, 50) / 1000,
+            percentile(s, 90) / 1000, percentile(s, 99) / 1000, percentile(s, 100) / 1000, percentile(s, 50, true), percentile(s, 100, true));
+        ofDrawBitmapString(line, x + 5, y + 30 + i * 15);
+    }
+    ofPopStyle();
+}
+
+//--------------------------------------------------------------
+void Profiler::toggle() {
+    visible = !visible;
+}
+
+//--------------------------------------------------------------
+bool Profiler::getVisible() const {
+    return visible;
+}
+
+//--------------------------------------------------------------
+uint64_t Profiler::allocations() {
+    return allocated.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------
+const char* Profiler::name(ProfileSection s) {
+    switch(s) {
+        case PROFILE_FRAME: return "frame";
+        case PROFILE_DRAW: return "deck draw";
+        case PROFILE_CLICK: return "click";
+        case PROFILE_HINT: return "hint";
+        case PROFILE_UNDO: return "undo";
+        case PROFILE_AUTOCOMPLETE: return "autocomplete";
+        case PROFILE_SAVE_SCORE: return "save score";
+        default: return "best score";
+    }
+}
+
+//--------------------------------------------------------------
+ProfileScope::ProfileScope(ProfileSection s) : section(s), start(std::chrono::steady_clock::now()), allocs(Profiler::allocations()) {}
+
+//--------------------------------------------------------------
+ProfileScope::~ProfileScope() {
+    profiler.add(section, std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count(),
+        Profiler::allocations() - allocs);
+}
@@ -0,0 +1,71 @@
+
+
+#ifndef profiler_hpp
+#define profiler_hpp
+
+#include "ofMain.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define PROFILE_WINDOW 240 // latest samples of each section the percentiles are taken from
+#define PROFILE_HISTORY 262144 // samples kept for the csv, later ones are only shown
+
+//------------------------------------------------------------------------------
+
+enum ProfileSection {PROFILE_FRAME, PROFILE_DRAW, PROFILE_CLICK, PROFILE_HINT, PROFILE_UNDO,
+    PROFILE_AUTOCOMPLETE, PROFILE_SAVE_SCORE, PROFILE_BEST_SCORE, PROFILE_SECTIONS};
+
+// one timed call, 16 bytes
+struct ProfileSample {
+    uint32_t frame; // frame it happened in
+    uint32_t section; // ProfileSection
+    float micros; // time it took
+    uint32_t allocs; // heap allocations meanwhile, on any thread
+};
+
+//------------------------------------------------------------------------------
+
+// times sections of the game and counts heap allocations, shows rolling percentiles over the table
+// and writes every sample to a csv, a frame is ofApp::update and ofApp::draw together
+// and its allocations are everything allocated since the previous frame
+class Profiler {
+public:
+    Profiler();
+    void add(ProfileSection s, float micros, uint32_t allocs);
+    void beginFrame();
+    void endFrame();
+    float percentile(ProfileSection s, float p, bool allocs = false) const;
+    bool save(const std::string &path) const;
+    void draw(float x, float y) const;
+    void toggle();
+    bool getVisible() const;
+    static uint64_t allocations();
+    static const char* name(ProfileSection s);
+private:
+    float times[PROFILE_SECTIONS][PROFILE_WINDOW]; // microseconds, a ring per section
+    uint32_t allocs[PROFILE_SECTIONS][PROFILE_WINDOW];
+    uint32_t counts[PROFILE_SECTIONS]; // samples so far, the next one goes to counts % PROFILE_WINDOW
+    std::vector<ProfileSample> history; // reserved up front so keeping it doesn't allocate
+    uint32_t frame;
+    std::chrono::steady_clock::time_point frameStart;
+    uint64_t frameAllocs; // allocation counter at the end of the last frame
+    bool visible;
+};
+
+extern Profiler profiler; // one for the whole game, Deck and ofApp record into it
+
+//------------------------------------------------------------------------------
+
+// times the rest of the block it is declared in
+class ProfileScope {
+public:
+    ProfileScope(ProfileSection s);
+    ~ProfileScope();
+private:
+    ProfileSection section;
+    std::chrono::steady_clock::time_point start;
+    uint64_t allocs;
+};
+
+#endif /* profiler_hpp */
@@ -0,0 +1,93 @@
+#include "rankTree.hpp"
+
+//--------------------------------------------------------------
+RankTree::RankTree() : root(-1), seed(2463534242u) {}
+
+//--------------------------------------------------------------
+void RankTree::clear() {
+    nodes.clear();
+    root = -1;
+}
+
+//--------------------------------------------------------------
+void RankTree::insert(int64_t key) { // equal keys are kept, each one counts
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    Node n = {key, seed, -1, -1, 1};
+    nodes.push_back(n);
+    int32_t left, right;
+    split(root, key, left, right); // keys below the new one and the rest
+    root = merge(merge(left, nodes.size() - 1), right);
+}
+
+//--------------------------------------------------------------
+int64_t RankTree::size() const {
+    return sizeOf(root);
+}
+
+//--------------------------------------------------------------
+int64_t RankTree::countLess(int64_t key) const { // how many keys are smaller
+    int64_t count = 0;
+    for(int32_t n = root; n != -1;) {
+        if(nodes[n].key < key) {
+            count += sizeOf(nodes[n].left) + 1; // the node and everything left of it
+            n = nodes[n].right;
+        } else n = nodes[n].left;
+    }
+    return count;
+}
+
+//--------------------------------------------------------------
+int64_t RankTree::kth(int64_t k) const { // k-th smallest key counting from 0, check size first
+    int32_t n = root;
+    while(true) {
+        int32_t left = sizeOf(nodes[n].left);
+        if(k < left) n = nodes[n].left;
+        else if(k == left) return nodes[n].key;
+        else {
+            k -= left + 1;
+            n = nodes[n].right;
+        }
+    }
+}
+
+//--------------------------------------------------------------
+int32_t RankTree::sizeOf(int32_t n) const {
+    return n == -1 ? 0 : nodes[n].size;
+}
+
+//--------------------------------------------------------------
+void RankTree::update(int32_t n) {
+    nodes[n].size = sizeOf(nodes[n].left) + sizeOf(nodes[n].right) + 1;
+}
+
+//--------------------------------------------------------------
+void RankTree::split(int32_t n, int64_t key, int32_t &left, int32_t &right) { // keys below key go left
+    if(n == -1) {
+        left = right = -1;
+        return;
+    }
+    if(nodes[n].key < key) {
+        split(nodes[n].right, key, nodes[n].right, right);
+        left = n;
+    } else {
+        split(nodes[n].left, key, left, nodes[n].left);
+        right = n;
+    }
+    update(n);
+}
+
+//--------------------------------------------------------------
+int32_t RankTree::merge(int32_t left, int32_t right) { // every key of left is below every key of right
+    if(left == -1) return right;
+    if(right == -1) return left;
+    if(nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
@@ -0,0 +1,36 @@
+#ifndef rankTree_hpp
+#define rankTree_hpp
+
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// order statistic treap over 64 bit keys, every node knows the size of its subtree so
+// counting the keys below a value and finding the k-th smallest key are both logarithmic
+class RankTree {
+public:
+    RankTree();
+    void clear();
+    void insert(int64_t key);
+    int64_t size() const;
+    int64_t countLess(int64_t key) const;
+    int64_t kth(int64_t k) const;
+private:
+    struct Node {
+        int64_t key;
+        uint32_t priority; // heap order keeps the tree balanced on average
+        int32_t left; // -1 when there is none
+        int32_t right;
+        int32_t size; // nodes in this subtree
+    };
+    std::vector<Node> nodes; // all nodes, linked by index
+    int32_t root; // -1 when empty
+    uint32_t seed; // priorities come from a xorshift
+    int32_t sizeOf(int32_t n) const;
+    void update(int32_t n);
+    void split(int32_t n, int64_t key, int32_t &left, int32_t &right);
+    int32_t merge(int32_t left, int32_t right);
+};
+
+#endif /* rankTree_hpp */
@@ -4,10 +4,11 @@
 
 #include "ofMain.h"
 #include "pile.hpp"
+#include "cardAtlas.hpp"
 
 class Home : public Pile {
 public:
-    Home(ofVec2f pos, ofVec2f s, bool top);
+    Home(ofVec2f pos, ofVec2f s, bool top, const CardAtlas &a);
     void draw();
     void setSuit(int s);
     int getSuit();
@@ -16,7 +17,7 @@ public:
 private:
     int currentRank;
     int suit = -1;
-    ofImage homeImage;
+    const CardAtlas *atlas; // holds the home picture
 
 };
 
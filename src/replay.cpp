@@ -0,0 +1,161 @@
+#include "replay.hpp"
+#include "moveLog.hpp"
+#include <cstdio>
+#include <cstring>
+
+//--------------------------------------------------------------
+Replay::Replay() {
+    reset(0);
+}
+
+//--------------------------------------------------------------
+void Replay::reset(int deal) { // new game, no events and no result yet
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, 4);
+    header.version = REPLAY_VERSION;
+    header.deal = deal;
+    events.clear();
+}
+
+//--------------------------------------------------------------
+void Replay::addMove(uint32_t time, const Move &m) {
+    add(time, EVENT_MOVE, m);
+}
+
+//--------------------------------------------------------------
+void Replay::addUndo(uint32_t time) {
+    add(time, EVENT_UNDO, Move());
+}
+
+//--------------------------------------------------------------
+void Replay::addRedo(uint32_t time) {
+    add(time, EVENT_REDO, Move());
+}
+
+//--------------------------------------------------------------
+void Replay::add(uint32_t time, uint8_t kind, const Move &m) {
+    ReplayEvent e;
+    e.time = time;
+    e.kind = kind;
+    e.from = kind == EVENT_MOVE ? m.from : 0;
+    e.to = kind == EVENT_MOVE ? m.to : 0;
+    e.count = kind == EVENT_MOVE ? m.count : 0;
+    events.push_back(e);
+}
+
+//--------------------------------------------------------------
+void Replay::finish(bool won, int score, int seconds, int moves) {
+    header.won = won;
+    header.score = score;
+    header.seconds = seconds;
+    header.moves = moves;
+}
+
+//--------------------------------------------------------------
+bool Replay::save(const std::string &path) const {
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    ReplayHeader h = header;
+    h.events = events.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if(ok && !events.empty()) ok = fwrite(events.data(), sizeof(ReplayEvent), events.size(), f) == events.size();
+    if(fclose(f) != 0) ok = false;
+    return ok;
+}
+
+//--------------------------------------------------------------
+bool Replay::load(const std::string &path) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.insert(data.end(), buffer, buffer + n);
+    fclose(f);
+    return read(data.data(), data.size());
+}
+
+//--------------------------------------------------------------
+bool Replay::read(const uint8_t *data, size_t size) { // from memory, false when it isn't a whole replay
+    if(size < sizeof(ReplayHeader)) return false;
+    ReplayHeader h;
+    memcpy(&h, data, sizeof(h));
+    if(memcmp(h.magic, REPLAY_MAGIC, 4) != 0 || h.version != REPLAY_VERSION) return false;
+    if(size < sizeof(ReplayHeader) + (size_t)h.events * sizeof(ReplayEvent)) return false; // cut short
+    header = h;
+    events.resize(h.events);
+    if(h.events > 0) memcpy(events.data(), data + sizeof(ReplayHeader), h.events * sizeof(ReplayEvent));
+    return true;
+}
+
+//--------------------------------------------------------------
+const ReplayHeader& Replay::getHeader() const {
+    return header;
+}
+
+//--------------------------------------------------------------
+const std::vector<ReplayEvent>& Replay::getEvents() const {
+    return events;
+}
+
+//--------------------------------------------------------------
+ReplayVerdict validateReplay(const Replay &r, int *failed) {
+    const ReplayHeader &h = r.getHeader();
+    const std::vector<ReplayEvent> &events = r.getEvents();
+    GameState state = GameState::deal(h.deal);
+    MoveLog log;
+    log.reset(state);
+    int score = 0, moves = 0;
+    uint32_t time = 0;
+    for(int i = 0; i < events.size(); i++) {
+        const ReplayEvent &e = events[i];
+        if(failed) *failed = i;
+        if(e.time < time) return REPLAY_TIME_BACKWARDS;
+        time = e.time;
+        switch(e.kind) {
+            case EVENT_MOVE: { // same checks and score as Deck::check and Deck::moveCard
+                Move m;
+                m.from = e.from;
+                m.to = e.to;
+                m.count = e.count;
+                if(!state.isLegal(m)) return REPLAY_ILLEGAL_MOVE;
+                state.apply(m);
+                log.push(m, state);
+                if(m.to >= HOME_BASE) score += 10;
+                moves++;
+                break;
+            }
+            case EVENT_UNDO: // Deck::undo
+                if(!log.canUndo()) return REPLAY_NOTHING_TO_UNDO;
+                score -= 5 + 10 * log.undo(state).homeDelta;
+                break;
+            case EVENT_REDO: // Deck::redo
+                if(!log.canRedo()) return REPLAY_NOTHING_TO_REDO;
+                score += 10 * log.redo(state).homeDelta;
+                moves++;
+                break;
+            default: return REPLAY_ILLEGAL_MOVE;
+        }
+    }
+    if(failed) *failed = -1; // the result is wrong, not an event
+    if(h.won != state.isWon()) return REPLAY_NOT_WON;
+    if(h.moves != moves) return REPLAY_WRONG_MOVES;
+    if(h.seconds <= 0 || (int64_t)h.seconds * 1000 > time || time >= (int64_t)h.seconds * 1000 + REPLAY_CLOCK_SLACK) return REPLAY_WRONG_TIME;
+    if(h.won && h.score != score + 1000000 / h.seconds) return REPLAY_WRONG_SCORE; // final score from ofApp::mousePressed
+    return REPLAY_OK;
+}
+
+//--------------------------------------------------------------
+const char* verdictName(ReplayVerdict v) {
+    switch(v) {
+        case REPLAY_OK: return "ok";
+        case REPLAY_ILLEGAL_MOVE: return "illegal move";
+        case REPLAY_NOTHING_TO_UNDO: return "undo without a move";
+        case REPLAY_NOTHING_TO_REDO: return "redo without an undo";
+        case REPLAY_TIME_BACKWARDS: return "time goes backwards";
+        case REPLAY_NOT_WON: return "result doesn't match the game";
+        case REPLAY_WRONG_MOVES: return "wrong move count";
+        case REPLAY_WRONG_SCORE: return "wrong score";
+        default: return "wrong time";
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef replay_hpp
+#define replay_hpp
+
+#include "gameState.hpp"
+#include <string>
+#include <vector>
+
+#define REPLAY_MAGIC "FCRP"
+#define REPLAY_VERSION 1
+#define REPLAY_CLOCK_SLACK 2000 // milliseconds the game clock may trail the last event
+
+//------------------------------------------------------------------------------
+
+enum ReplayEventKind {EVENT_MOVE, EVENT_UNDO, EVENT_REDO};
+
+// file header, followed by one ReplayEvent per action
+struct ReplayHeader {
+    char magic[4]; // REPLAY_MAGIC
+    uint32_t version; // REPLAY_VERSION
+    int32_t deal; // deal id the game started from
+    uint32_t events; // amount of events in the file
+    uint8_t won; // did the game end with every card home
+    uint8_t unused[3];
+    int32_t score; // final score as shown in the finished dialog
+    int32_t seconds; // time the clock showed
+    int32_t moves; // moves counter
+};
+
+// one action of the player, eight bytes
+struct ReplayEvent {
+    uint32_t time; // milliseconds since the deal
+    uint8_t kind; // ReplayEventKind
+    uint8_t from; // the move, only for EVENT_MOVE
+    uint8_t to;
+    uint8_t count;
+};
+
+enum ReplayVerdict {REPLAY_OK, REPLAY_ILLEGAL_MOVE, REPLAY_NOTHING_TO_UNDO, REPLAY_NOTHING_TO_REDO,
+    REPLAY_TIME_BACKWARDS, REPLAY_NOT_WON, REPLAY_WRONG_MOVES, REPLAY_WRONG_SCORE, REPLAY_WRONG_TIME};
+
+//------------------------------------------------------------------------------
+
+// everything the player did in one game, enough to play it again
+class Replay {
+public:
+    Replay();
+    void reset(int deal);
+    void addMove(uint32_t time, const Move &m);
+    void addUndo(uint32_t time);
+    void addRedo(uint32_t time);
+    void finish(bool won, int score, int seconds, int moves);
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+    bool read(const uint8_t *data, size_t size);
+    const ReplayHeader& getHeader() const;
+    const std::vector<ReplayEvent>& getEvents() const;
+private:
+    ReplayHeader header;
+    std::vector<ReplayEvent> events;
+    void add(uint32_t time, uint8_t kind, const Move &m);
+};
+
+//------------------------------------------------------------------------------
+
+// plays the replay through the same rules and scoring as Deck, failed is the event that broke them
+ReplayVerdict validateReplay(const Replay &r, int *failed = nullptr);
+const char* verdictName(ReplayVerdict v);
+
+#endif /* replay_hpp */
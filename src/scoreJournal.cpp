@@ -0,0 +1,155 @@
+
+
+#include "scoreJournal.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------
+ScoreJournal::ScoreJournal() : fd(-1), statsChanged(false), pending(0), compactWanted(false), stopping(false) {}
+
+//--------------------------------------------------------------
+ScoreJournal::~ScoreJournal() {
+    close();
+}
+
+//--------------------------------------------------------------
+bool ScoreJournal::open(const std::string &p) { // reads every record and keeps the file open for appending
+    close();
+    path = p;
+    records.clear();
+    games.clear();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+    std::vector<ScoreRecord> disk(st.st_size / sizeof(ScoreRecord));
+    if(!disk.empty() && pread(fd, disk.data(), disk.size() * sizeof(ScoreRecord), 0) != (ssize_t)(disk.size() * sizeof(ScoreRecord))) {
+        close();
+        return false;
+    }
+    for(int i = 0; i < disk.size(); i++) {
+        const ScoreRecord &r = disk[i];
+        if(r.magic != JOURNAL_MAGIC || r.check != checksum(r)) continue; // damaged
+        if(!games.insert(r.game).second) continue; // same game twice
+        records.push_back(r);
+    }
+    if(st.st_size % sizeof(ScoreRecord) != 0) ftruncate(fd, disk.size() * sizeof(ScoreRecord)); // torn last append, next one starts on a record boundary
+    compactWanted = records.size() != disk.size();
+    // the stats file covers the journal up to some record, only what came after it is added
+    if(!stats.load(path + ".stats") || stats.getRecords() > records.size() ||
+       (stats.getRecords() > 0 && records[stats.getRecords() - 1].game != stats.getLastGame())) stats.clear(); // from another journal, start over
+    statsChanged = stats.getRecords() < records.size();
+    for(size_t i = stats.getRecords(); i < records.size(); i++) stats.add(records[i]);
+    stopping = false;
+    pending = 0;
+    worker = std::thread(&ScoreJournal::run, this);
+    return true;
+}
+
+//--------------------------------------------------------------
+void ScoreJournal::close() { // syncs whatever is left
+    if(worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> l(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    if(fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+    fd = -1;
+}
+
+//--------------------------------------------------------------
+bool ScoreJournal::append(ScoreRecord r) { // false when the game is already in the journal or the write failed
+    if(games.count(r.game)) return false;
+    r.magic = JOURNAL_MAGIC;
+    r.check = checksum(r);
+    bool batchFull;
+    {
+        std::lock_guard<std::mutex> l(lock); // compaction swaps fd on the worker
+        if(fd < 0 || write(fd, &r, sizeof(r)) != sizeof(r)) return false;
+        batchFull = ++pending >= JOURNAL_SYNC_BATCH;
+        records.push_back(r); // under the lock because compaction reads it
+        stats.add(r); // and the worker saves these
+        statsChanged = true;
+    }
+    games.insert(r.game);
+    if(batchFull) wake.notify_one(); // otherwise the worker syncs after JOURNAL_SYNC_DELAY
+    return true;
+}
+
+//--------------------------------------------------------------
+void ScoreJournal::flush() { // fsync now instead of waiting for the worker
+    std::lock_guard<std::mutex> l(lock);
+    if(fd >= 0 && pending > 0) fsync(fd);
+    pending = 0;
+}
+
+//--------------------------------------------------------------
+const std::vector<ScoreRecord>& ScoreJournal::getRecords() const {
+    return records;
+}
+
+//--------------------------------------------------------------
+const ScoreStats& ScoreJournal::getStats() const { // up to date with every append
+    return stats;
+}
+
+//--------------------------------------------------------------
+uint32_t ScoreJournal::checksum(const ScoreRecord &r) { // FNV-1a over the fields after check
+    const uint8_t *p = (const uint8_t *)&r + offsetof(ScoreRecord, game);
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < sizeof(ScoreRecord) - offsetof(ScoreRecord, game); i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+//--------------------------------------------------------------
+void ScoreJournal::run() { // worker thread
+    std::unique_lock<std::mutex> l(lock);
+    while(true) {
+        wake.wait_for(l, std::chrono::milliseconds(JOURNAL_SYNC_DELAY), [this] { return stopping || compactWanted || pending >= JOURNAL_SYNC_BATCH; });
+        if(compactWanted) compact();
+        if(pending > 0) {
+            fsync(fd);
+            pending = 0;
+        }
+        if(statsChanged) saveStats(); // after the records they count are on disk
+        if(stopping) return;
+    }
+}
+
+//--------------------------------------------------------------
+void ScoreJournal::compact() { // rewrites the file with the valid records only, called with the lock held
+    compactWanted = false;
+    std::string tmp = path + ".tmp";
+    int out = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644); // kept for appending after the rename
+    if(out < 0) return;
+    size_t bytes = records.size() * sizeof(ScoreRecord); // every record is in the file already, appends wait for the lock
+    bool ok = bytes == 0 || write(out, records.data(), bytes) == (ssize_t)bytes;
+    ok = fsync(out) == 0 && ok;
+    if(!ok || rename(tmp.c_str(), path.c_str()) != 0) { // the old file and fd stay in use
+        ::close(out);
+        remove(tmp.c_str());
+        return;
+    }
+    ::close(fd); // the old file is gone, appends go to the new one
+    fd = out; // still valid under the new name
+    pending = 0;
+}
+
+//--------------------------------------------------------------
+void ScoreJournal::saveStats() { // called with the lock held
+    statsChanged = !stats.save(path + ".stats");
+}
@@ -0,0 +1,53 @@
+
+
+#ifndef scoreJournal_hpp
+#define scoreJournal_hpp
+
+#include "scoreRecord.hpp"
+#include "scoreStats.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define JOURNAL_SYNC_BATCH 8 // appends that make the worker fsync straight away
+#define JOURNAL_SYNC_DELAY 2000 // milliseconds an append may wait for its fsync
+
+//------------------------------------------------------------------------------
+
+// append only score file, finishing a game writes one record and a worker thread fsyncs appends in batches
+// and rewrites the file without damaged or repeated records when it finds any
+class ScoreJournal {
+public:
+    ScoreJournal();
+    ~ScoreJournal();
+    bool open(const std::string &path);
+    void close();
+    bool append(ScoreRecord r);
+    void flush();
+    const std::vector<ScoreRecord>& getRecords() const;
+    const ScoreStats& getStats() const;
+    static uint32_t checksum(const ScoreRecord &r);
+private:
+    ScoreJournal(const ScoreJournal &) = delete;
+    ScoreJournal& operator=(const ScoreJournal &) = delete;
+    std::string path; // journal file
+    int fd; // opened for appending, -1 when closed
+    std::vector<ScoreRecord> records; // every valid game in file order, changed by the owner's thread under the lock
+    std::unordered_set<uint64_t> games; // ids of the games in records
+    ScoreStats stats; // totals of records, saved next to the journal
+    bool statsChanged; // stats differ from their file
+    std::mutex lock; // guards fd, pending and the flags below against the worker
+    std::condition_variable wake; // tells the worker there is something to do
+    std::thread worker; // fsyncs and compacts
+    int pending; // appends not synced yet
+    bool compactWanted; // file holds records the journal skipped
+    bool stopping; // close was called
+    void run();
+    void compact();
+    void saveStats();
+};
+
+#endif /* scoreJournal_hpp */
@@ -0,0 +1,24 @@
+
+
+#ifndef scoreRecord_hpp
+#define scoreRecord_hpp
+
+#include <cstdint>
+
+#define JOURNAL_MAGIC 0x52435346 // "FSCR", a torn or overwritten record doesn't start with it
+
+//------------------------------------------------------------------------------
+
+// one finished game, the journal file is nothing but these one after another
+struct ScoreRecord {
+    uint32_t magic; // JOURNAL_MAGIC
+    uint32_t check; // checksum of everything below
+    uint64_t game; // unique id of the game, later records with the same id are ignored
+    int32_t deal; // deal id, -1 when unknown
+    int32_t score; // final score
+    int32_t seconds; // time the game took
+    int32_t moves; // moves counter
+    int64_t time; // unix time the game was finished, 0 when unknown
+};
+
+#endif /* scoreRecord_hpp */
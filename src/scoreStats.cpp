@@ -0,0 +1,170 @@
+
+
+#include "scoreStats.hpp"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// stats file: header, then one entry per deal
+struct StatsHeader {
+    char magic[4]; // STATS_MAGIC
+    uint32_t version; // STATS_VERSION
+    int64_t records;
+    uint64_t lastGame;
+    int32_t bestScore;
+    int32_t bestSeconds;
+    int32_t bestMoves;
+    int32_t deals; // entries after the header
+    int64_t totalScore;
+    int64_t totalSeconds;
+    int64_t totalMoves;
+};
+
+struct StatsEntry {
+    int32_t deal;
+    DealStats stats;
+};
+
+//--------------------------------------------------------------
+ScoreStats::ScoreStats() {
+    clear();
+}
+
+//--------------------------------------------------------------
+void ScoreStats::clear() {
+    records = 0;
+    lastGame = 0;
+    bestScore = 0;
+    bestSeconds = INT32_MAX;
+    bestMoves = INT32_MAX;
+    totalScore = 0;
+    totalSeconds = 0;
+    totalMoves = 0;
+    deals.clear();
+}
+
+//--------------------------------------------------------------
+void ScoreStats::add(const ScoreRecord &r) {
+    records++;
+    lastGame = r.game;
+    if(r.score > bestScore) bestScore = r.score;
+    if(r.seconds < bestSeconds) bestSeconds = r.seconds;
+    if(r.moves < bestMoves) bestMoves = r.moves;
+    totalScore += r.score;
+    totalSeconds += r.seconds;
+    totalMoves += r.moves;
+    if(r.deal < 0) return; // no deal to keep bests for
+    auto it = deals.find(r.deal);
+    if(it == deals.end()) {
+        DealStats d = {1, r.score, r.seconds, r.moves};
+        deals[r.deal] = d;
+        return;
+    }
+    DealStats &d = it->second;
+    d.games++;
+    if(r.score > d.bestScore) d.bestScore = r.score;
+    if(r.seconds < d.bestSeconds) d.bestSeconds = r.seconds;
+    if(r.moves < d.bestMoves) d.bestMoves = r.moves;
+}
+
+//--------------------------------------------------------------
+bool ScoreStats::save(const std::string &path) const { // written next to the journal through a temporary file
+    std::string tmp = path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if(!f) return false;
+    StatsHeader h;
+    memcpy(h.magic, STATS_MAGIC, 4);
+    h.version = STATS_VERSION;
+    h.records = records;
+    h.lastGame = lastGame;
+    h.bestScore = bestScore;
+    h.bestSeconds = bestSeconds;
+    h.bestMoves = bestMoves;
+    h.deals = deals.size();
+    h.totalScore = totalScore;
+    h.totalSeconds = totalSeconds;
+    h.totalMoves = totalMoves;
+    std::vector<StatsEntry> entries;
+    entries.reserve(deals.size());
+    for(auto it = deals.begin(); it != deals.end(); ++it) entries.push_back({it->first, it->second});
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if(ok && !entries.empty()) ok = fwrite(entries.data(), sizeof(StatsEntry), entries.size(), f) == entries.size();
+    if(fclose(f) != 0) ok = false;
+    if(!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+bool ScoreStats::load(const std::string &path) { // false leaves the stats empty
+    clear();
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f) return false;
+    StatsHeader h;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && memcmp(h.magic, STATS_MAGIC, 4) == 0 && h.version == STATS_VERSION && h.deals >= 0;
+    std::vector<StatsEntry> entries(ok ? h.deals : 0);
+    if(ok && !entries.empty()) ok = fread(entries.data(), sizeof(StatsEntry), entries.size(), f) == entries.size();
+    fclose(f);
+    if(!ok) return false;
+    records = h.records;
+    lastGame = h.lastGame;
+    bestScore = h.bestScore;
+    bestSeconds = h.bestSeconds;
+    bestMoves = h.bestMoves;
+    totalScore = h.totalScore;
+    totalSeconds = h.totalSeconds;
+    totalMoves = h.totalMoves;
+    for(int i = 0; i < entries.size(); i++) deals[entries[i].deal] = entries[i].stats;
+    return true;
+}
+
+//--------------------------------------------------------------
+int64_t ScoreStats::getRecords() const {
+    return records;
+}
+
+//--------------------------------------------------------------
+uint64_t ScoreStats::getLastGame() const {
+    return lastGame;
+}
+
+//--------------------------------------------------------------
+int ScoreStats::getBestScore() const {
+    return bestScore;
+}
+
+//--------------------------------------------------------------
+int ScoreStats::getBestSeconds() const {
+    return bestSeconds;
+}
+
+//--------------------------------------------------------------
+int ScoreStats::getBestMoves() const {
+    return bestMoves;
+}
+
+//--------------------------------------------------------------
+double ScoreStats::getAverageScore() const {
+    return records > 0 ? (double)totalScore / records : 0;
+}
+
+//--------------------------------------------------------------
+double ScoreStats::getAverageSeconds() const {
+    return records > 0 ? (double)totalSeconds / records : 0;
+}
+
+//--------------------------------------------------------------
+double ScoreStats::getAverageMoves() const {
+    return records > 0 ? (double)totalMoves / records : 0;
+}
+
+//--------------------------------------------------------------
+const DealStats* ScoreStats::getDeal(int deal) const { // nullptr when the deal was never finished
+    auto it = deals.find(deal);
+    return it == deals.end() ? nullptr : &it->second;
+}
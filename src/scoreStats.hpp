@@ -0,0 +1,54 @@
+
+
+#ifndef scoreStats_hpp
+#define scoreStats_hpp
+
+#include "scoreRecord.hpp"
+#include <string>
+#include <unordered_map>
+
+#define STATS_MAGIC "FSST"
+#define STATS_VERSION 1
+
+//------------------------------------------------------------------------------
+
+// bests of one deal
+struct DealStats {
+    int32_t games; // times the deal was finished
+    int32_t bestScore;
+    int32_t bestSeconds;
+    int32_t bestMoves;
+};
+
+//------------------------------------------------------------------------------
+
+// running totals of the score journal, every record is folded in once so reading them costs nothing
+class ScoreStats {
+public:
+    ScoreStats();
+    void clear();
+    void add(const ScoreRecord &r);
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+    int64_t getRecords() const;
+    uint64_t getLastGame() const;
+    int getBestScore() const;
+    int getBestSeconds() const;
+    int getBestMoves() const;
+    double getAverageScore() const;
+    double getAverageSeconds() const;
+    double getAverageMoves() const;
+    const DealStats* getDeal(int deal) const;
+private:
+    int64_t records; // journal records folded in, in file order
+    uint64_t lastGame; // id of the last of them, tells whether the stats still match the journal
+    int32_t bestScore; // 0 until a game is added
+    int32_t bestSeconds; // INT32_MAX until a game is added
+    int32_t bestMoves; // INT32_MAX until a game is added
+    int64_t totalScore;
+    int64_t totalSeconds;
+    int64_t totalMoves;
+    std::unordered_map<int32_t, DealStats> deals; // deals the journal knows, imported scores have none
+};
+
+#endif /* scoreStats_hpp */
@@ -0,0 +1,151 @@
+
+
+#include "sessionPool.hpp"
+
+#define SLOT_MASK ((1u << SESSION_SLOT_BITS) - 1)
+
+//--------------------------------------------------------------
+SessionPool::SessionPool() : used(0), count(0) {}
+
+//--------------------------------------------------------------
+uint32_t SessionPool::open(int deal) { // new game of the deal, 0 when the pool is full
+    uint32_t slot;
+    uint32_t reuses = 1;
+    if(!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        reuses = (blocks[slot / SESSION_BLOCK][slot % SESSION_BLOCK].id >> SESSION_SLOT_BITS) + 1;
+        if(reuses << SESSION_SLOT_BITS == 0) reuses = 1; // wrapped around, 0 would make the id invalid for slot 0
+    } else {
+        if(used > SLOT_MASK) return 0;
+        slot = used++;
+        if(slot / SESSION_BLOCK == blocks.size()) blocks.push_back(std::unique_ptr<Session[]>(new Session[SESSION_BLOCK]));
+    }
+    Session &s = blocks[slot / SESSION_BLOCK][slot % SESSION_BLOCK];
+    s.state = GameState::deal(deal);
+    s.id = reuses << SESSION_SLOT_BITS | slot;
+    s.deal = deal;
+    s.score = 0;
+    s.moves = 0;
+    s.first = 0;
+    s.logSize = 0;
+    s.cursor = 0;
+    count++;
+    return s.id;
+}
+
+//--------------------------------------------------------------
+SessionResult SessionPool::close(uint32_t id) {
+    Session *s = find(id);
+    if(!s) return SESSION_NO_GAME;
+    s->deal = -1; // the id stays for counting reuses
+    freeSlots.push_back(id & SLOT_MASK);
+    count--;
+    return SESSION_OK;
+}
+
+//--------------------------------------------------------------
+const Session* SessionPool::get(uint32_t id) const {
+    return const_cast<SessionPool*>(this)->find(id);
+}
+
+//--------------------------------------------------------------
+SessionResult SessionPool::move(uint32_t id, const Move &m, SessionDelta &d) { // same checks and score as Deck::check and Deck::moveCard
+    Session *s = find(id);
+    if(!s) return SESSION_NO_GAME;
+    if(!s->state.isLegal(m)) return SESSION_ILLEGAL_MOVE;
+    if(s->cursor == SESSION_LOG) { // forget the oldest move, it can't be undone any more
+        s->first = (s->first + 1) % SESSION_LOG;
+        s->cursor--;
+    }
+    LogEntry e;
+    e.from = m.from;
+    e.to = m.to;
+    e.count = m.count;
+    e.homeDelta = m.to >= HOME_BASE ? 1 : 0;
+    s->state.apply(m);
+    entry(*s, s->cursor++) = e;
+    s->logSize = s->cursor; // a new move drops whatever could be redone
+    s->score += 10 * e.homeDelta;
+    s->moves++;
+    fill(*s, d, e, true);
+    return SESSION_OK;
+}
+
+//--------------------------------------------------------------
+SessionResult SessionPool::undo(uint32_t id, SessionDelta &d) { // Deck::undo
+    Session *s = find(id);
+    if(!s) return SESSION_NO_GAME;
+    if(s->cursor == 0) return SESSION_NOTHING_TO_UNDO;
+    const LogEntry &e = entry(*s, --s->cursor);
+    s->state.revert(MoveLog::toMove(e));
+    s->score -= 5 + 10 * e.homeDelta;
+    fill(*s, d, e, false);
+    return SESSION_OK;
+}
+
+//--------------------------------------------------------------
+SessionResult SessionPool::redo(uint32_t id, SessionDelta &d) { // Deck::redo
+    Session *s = find(id);
+    if(!s) return SESSION_NO_GAME;
+    if(s->cursor == s->logSize) return SESSION_NOTHING_TO_REDO;
+    const LogEntry &e = entry(*s, s->cursor++);
+    s->state.apply(MoveLog::toMove(e));
+    s->score += 10 * e.homeDelta;
+    s->moves++;
+    fill(*s, d, e, true);
+    return SESSION_OK;
+}
+
+//--------------------------------------------------------------
+int SessionPool::size() const {
+    return count;
+}
+
+//--------------------------------------------------------------
+size_t SessionPool::memory() const { // bytes held by the arena
+    return blocks.size() * SESSION_BLOCK * sizeof(Session) + freeSlots.capacity() * sizeof(uint32_t);
+}
+
+//--------------------------------------------------------------
+Session* SessionPool::find(uint32_t id) { // nullptr for closed, stale and unknown ids
+    uint32_t slot = id & SLOT_MASK;
+    if(slot >= used) return nullptr;
+    Session &s = blocks[slot / SESSION_BLOCK][slot % SESSION_BLOCK];
+    return s.id == id && s.deal >= 0 ? &s : nullptr;
+}
+
+//--------------------------------------------------------------
+uint8_t SessionPool::lowestCard(const GameState &s, int location, int n) { // lowest of the top n cards of a location
+    if(location >= HOME_BASE) return (s.homeRank(location - HOME_BASE) - 1) * 4 + location - HOME_BASE;
+    if(location >= FREECELL_BASE) return s.freeCell(location - FREECELL_BASE);
+    return s.columnCard(location, s.columnSize(location) - n);
+}
+
+//--------------------------------------------------------------
+void SessionPool::fill(const Session &s, SessionDelta &d, const LogEntry &e, bool forward) { // after the entry was applied or reverted
+    d.from = forward ? e.from : e.to;
+    d.to = forward ? e.to : e.from;
+    d.count = e.count;
+    d.card = lowestCard(s.state, d.to, e.count);
+    d.score = s.score;
+    d.moves = s.moves;
+    d.won = s.state.isWon();
+}
+
+//--------------------------------------------------------------
+LogEntry& SessionPool::entry(Session &s, int i) { // i-th remembered move, 0 is the oldest
+    return s.log[(s.first + i) % SESSION_LOG];
+}
+
+//--------------------------------------------------------------
+const char* resultName(SessionResult r) {
+    switch(r) {
+        case SESSION_OK: return "ok";
+        case SESSION_NO_GAME: return "no such game";
+        case SESSION_ILLEGAL_MOVE: return "illegal move";
+        case SESSION_NOTHING_TO_UNDO: return "nothing to undo";
+        case SESSION_NOTHING_TO_REDO: return "nothing to redo";
+        default: return "server full";
+    }
+}
@@ -0,0 +1,72 @@
+
+
+#ifndef sessionPool_hpp
+#define sessionPool_hpp
+
+#include "gameState.hpp"
+#include "moveLog.hpp"
+#include <memory>
+#include <vector>
+
+#define SESSION_LOG 512 // moves a session remembers for undo and redo, older ones are forgotten
+#define SESSION_BLOCK 4096 // sessions allocated at once
+#define SESSION_SLOT_BITS 22 // low bits of a session id pick the slot, the rest count its reuses
+
+//------------------------------------------------------------------------------
+
+// one game without anything to draw, scored like Deck
+struct Session {
+    GameState state;
+    uint32_t id; // slot and reuse count
+    int32_t deal; // -1 while the slot is free
+    int32_t score;
+    int32_t moves;
+    uint16_t first; // place of the oldest entry in log
+    uint16_t logSize; // entries including the redo tail
+    uint16_t cursor; // entries currently applied, counted from the oldest
+    LogEntry log[SESSION_LOG]; // ring, a move with the log full overwrites the oldest entry
+};
+
+// what a command changed, enough for a client to update its copy of the table
+struct SessionDelta {
+    uint8_t from; // location the cards left
+    uint8_t to; // location they went to
+    uint8_t count;
+    uint8_t card; // lowest of the moved cards
+    int32_t score;
+    int32_t moves;
+    bool won;
+};
+
+enum SessionResult {SESSION_OK, SESSION_NO_GAME, SESSION_ILLEGAL_MOVE, SESSION_NOTHING_TO_UNDO,
+    SESSION_NOTHING_TO_REDO, SESSION_POOL_FULL};
+
+//------------------------------------------------------------------------------
+
+// many games at once for the headless server, sessions live in blocks that are never moved or freed
+// so a closed slot is simply reused, ids carry a reuse count so a stale id can't reach the next game
+class SessionPool {
+public:
+    SessionPool();
+    uint32_t open(int deal);
+    SessionResult close(uint32_t id);
+    const Session* get(uint32_t id) const;
+    SessionResult move(uint32_t id, const Move &m, SessionDelta &d);
+    SessionResult undo(uint32_t id, SessionDelta &d);
+    SessionResult redo(uint32_t id, SessionDelta &d);
+    int size() const;
+    size_t memory() const;
+private:
+    std::vector<std::unique_ptr<Session[]>> blocks; // the arena
+    std::vector<uint32_t> freeSlots; // closed slots, reused first
+    uint32_t used; // slots handed out at least once
+    int count; // open sessions
+    Session* find(uint32_t id);
+    static uint8_t lowestCard(const GameState &s, int location, int n);
+    static void fill(const Session &s, SessionDelta &d, const LogEntry &e, bool forward);
+    static LogEntry& entry(Session &s, int i);
+};
+
+const char* resultName(SessionResult r);
+
+#endif /* sessionPool_hpp */
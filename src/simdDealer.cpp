@@ -0,0 +1,98 @@
+
+
+#include "simdDealer.hpp"
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// GameState::RNG gets its seed by value, so every call for a deal gives the same number r and
+// card i swaps with card 51 - r % (52 - i). Lanes keep one deal each, the deck is stored card by
+// card with all lanes next to each other so a row is one vector load.
+
+#if defined(__AVX512F__)
+
+#define LANES 16
+
+//--------------------------------------------------------------
+static void dealLanes(long first, uint8_t *order) {
+    alignas(64) int32_t deck[NUMBER_OF_CARDS][LANES];
+    for(int k = 0; k < NUMBER_OF_CARDS; k++) _mm512_store_si512((__m512i *)deck[k], _mm512_set1_epi32((NUMBER_OF_CARDS - 1) - k));
+    // the plain intrinsics pass an undefined source that GCC warns about, the masked ones name it
+    const __mmask16 all = 0xFFFF;
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i seed = _mm512_add_epi32(_mm512_set1_epi32((int)first), lane);
+    __m512i r = _mm512_add_epi32(_mm512_mullo_epi32(seed, _mm512_set1_epi32(214013)), _mm512_set1_epi32(2531011));
+    r = _mm512_mask_srli_epi32(zero, all, _mm512_and_si512(r, _mm512_set1_epi32(0x7fffffff)), 16);
+    __m512 rf = _mm512_mask_cvtepi32_ps(_mm512_setzero_ps(), all, r); // r < 2^15 so the float division floors exactly
+    for(int i = 0; i < NUMBER_OF_CARDS - 1; i++) {
+        int d = NUMBER_OF_CARDS - i;
+        __m512i q = _mm512_mask_cvttps_epi32(zero, all, _mm512_div_ps(rf, _mm512_set1_ps((float)d)));
+        __m512i rem = _mm512_sub_epi32(r, _mm512_mullo_epi32(q, _mm512_set1_epi32(d)));
+        __m512i j = _mm512_sub_epi32(_mm512_set1_epi32(NUMBER_OF_CARDS - 1), rem); // card to swap with
+        __m512i idx = _mm512_add_epi32(_mm512_mask_slli_epi32(zero, all, j, 4), lane); // j * LANES + lane
+        __m512i a = _mm512_load_si512((__m512i *)deck[i]);
+        __m512i b = _mm512_mask_i32gather_epi32(zero, all, idx, &deck[0][0], 4);
+        _mm512_store_si512((__m512i *)deck[i], b);
+        _mm512_i32scatter_epi32(&deck[0][0], idx, a, 4); // j >= i so this also covers j == i
+    }
+    for(int l = 0; l < LANES; l++) {
+        for(int k = 0; k < NUMBER_OF_CARDS; k++) order[l * NUMBER_OF_CARDS + k] = deck[k][l];
+    }
+}
+
+#elif defined(__AVX2__)
+
+#define LANES 8
+
+//--------------------------------------------------------------
+static void dealLanes(long first, uint8_t *order) {
+    alignas(32) int32_t deck[NUMBER_OF_CARDS][LANES];
+    for(int k = 0; k < NUMBER_OF_CARDS; k++) _mm256_store_si256((__m256i *)deck[k], _mm256_set1_epi32((NUMBER_OF_CARDS - 1) - k));
+    __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i seed = _mm256_add_epi32(_mm256_set1_epi32((int)first), lane);
+    __m256i r = _mm256_add_epi32(_mm256_mullo_epi32(seed, _mm256_set1_epi32(214013)), _mm256_set1_epi32(2531011));
+    r = _mm256_srli_epi32(_mm256_and_si256(r, _mm256_set1_epi32(0x7fffffff)), 16);
+    __m256 rf = _mm256_cvtepi32_ps(r); // r < 2^15 so the float division floors exactly
+    for(int i = 0; i < NUMBER_OF_CARDS - 1; i++) {
+        int d = NUMBER_OF_CARDS - i;
+        __m256i q = _mm256_cvttps_epi32(_mm256_div_ps(rf, _mm256_set1_ps((float)d)));
+        __m256i rem = _mm256_sub_epi32(r, _mm256_mullo_epi32(q, _mm256_set1_epi32(d)));
+        __m256i j = _mm256_sub_epi32(_mm256_set1_epi32(NUMBER_OF_CARDS - 1), rem); // card to swap with
+        __m256i idx = _mm256_add_epi32(_mm256_slli_epi32(j, 3), lane); // j * LANES + lane
+        __m256i a = _mm256_load_si256((__m256i *)deck[i]);
+        __m256i b = _mm256_i32gather_epi32(&deck[0][0], idx, 4);
+        _mm256_store_si256((__m256i *)deck[i], b);
+        alignas(32) int32_t js[LANES];
+        alignas(32) int32_t as[LANES];
+        _mm256_store_si256((__m256i *)js, j);
+        _mm256_store_si256((__m256i *)as, a);
+        for(int l = 0; l < LANES; l++) deck[js[l]][l] = as[l]; // AVX2 has no scatter, j >= i so this also covers j == i
+    }
+    for(int l = 0; l < LANES; l++) {
+        for(int k = 0; k < NUMBER_OF_CARDS; k++) order[l * NUMBER_OF_CARDS + k] = deck[k][l];
+    }
+}
+
+#else
+
+#define LANES 1
+
+//--------------------------------------------------------------
+static void dealLanes(long first, uint8_t *order) {
+    GameState::dealOrder(first, order);
+}
+
+#endif
+
+//--------------------------------------------------------------
+void dealOrders(long first, long count, uint8_t *order) {
+    long i = 0;
+    for(; i + LANES <= count; i += LANES) dealLanes(first + i, order + i * NUMBER_OF_CARDS); // full groups of lanes
+    for(; i < count; i++) GameState::dealOrder(first + i, order + i * NUMBER_OF_CARDS); // the rest one by one
+}
+
+//--------------------------------------------------------------
+int dealerLanes() {
+    return LANES;
+}
@@ -0,0 +1,19 @@
+
+
+#ifndef simdDealer_hpp
+#define simdDealer_hpp
+
+#include "gameState.hpp"
+
+//------------------------------------------------------------------------------
+
+// shuffles many deals side by side, 16 at a time with AVX-512, 8 with AVX2 and one by one otherwise
+// (pick the instruction set with -mavx512f or -mavx2), the result is byte for byte GameState::dealOrder
+
+// fills order with count deals starting at first, NUMBER_OF_CARDS bytes each
+void dealOrders(long first, long count, uint8_t *order);
+
+// amount of deals shuffled together by this build
+int dealerLanes();
+
+#endif /* simdDealer_hpp */
@@ -0,0 +1,155 @@
+
+
+#include "solver.hpp"
+#include "cardTables.hpp"
+#include "moveGenerator.hpp"
+#include "transpositionTable.hpp"
+#include <chrono>
+#include <queue>
+
+//------------------------------------------------------------------------------
+
+struct Node {
+    GameState state; // position after the move and autoplay
+    int parent; // index of the previous node, -1 for the start
+    Move move; // move that led here
+    int depth; // moves from the start
+};
+
+//--------------------------------------------------------------
+static bool safeHome(const GameState &s, uint8_t card) { // nothing will have to be stacked on the card anymore
+    if(s.homeRank(cardSuit(card)) != cardRank(card)) return false; // not next at home
+    const uint8_t *other = CARD_TABLES.otherSuits[card];
+    return s.homeRank(other[0]) >= CARD_TABLES.safeRank[card] && s.homeRank(other[1]) >= CARD_TABLES.safeRank[card]; // both suits of the other colour have the lower rank home
+}
+
+//--------------------------------------------------------------
+int autoplay(GameState &s, std::vector<Move> *played) {
+    int moved = 0;
+    bool again = true;
+    while(again) {
+        again = false;
+        for(int i = 0; i < NUMBER_OF_COLUMNS + NUMBER_OF_FREECELLS; i++) {
+            uint8_t card = (i < NUMBER_OF_COLUMNS) ? s.topCard(i) : s.freeCell(i - NUMBER_OF_COLUMNS);
+            if(card == NO_CARD || !safeHome(s, card)) continue;
+            Move m = {(uint8_t)i, (uint8_t)(HOME_BASE + cardSuit(card)), 1};
+            s.apply(m);
+            if(played) played->push_back(m);
+            moved++;
+            again = true;
+        }
+    }
+    return moved;
+}
+
+//--------------------------------------------------------------
+static int heuristic(const GameState &s) { // rough amount of work left, lower is closer to the end
+    int h = 2 * (NUMBER_OF_CARDS - s.cardsAtHome()); // cards still to go home
+    for(int i = 0; i < NUMBER_OF_COLUMNS; i++) {
+        int lowest = 13; // lowest rank seen from the bottom of the column
+        for(int r = 0; r < s.columnSize(i); r++) {
+            int rank = cardRank(s.columnCard(i, r));
+            if(rank > lowest) h++; // card buries a lower one that goes home earlier
+            else lowest = rank;
+        }
+    }
+    h += NUMBER_OF_FREECELLS - s.emptyFreeCells(); // occupied free cells
+    h -= s.emptyColumns(); // empty columns make everything easier
+    return h;
+}
+
+//--------------------------------------------------------------
+static bool fitsFreeCells(const GameState &s, const Move &m, int freeCells) { // could the move be made with only freeCells free cells
+    if(m.to >= HOME_BASE) return true;
+    if(m.to >= FREECELL_BASE) return NUMBER_OF_FREECELLS - s.emptyFreeCells() < freeCells;
+    return m.count <= s.capacity(s.columnSize(m.to) == 0, freeCells);
+}
+
+//--------------------------------------------------------------
+static bool stopped(long nodes, const std::atomic<bool> *cancel, int millis, std::chrono::steady_clock::time_point start) {
+    if(nodes % 256 != 0) return false; // the clock is too slow to read on every node
+    if(cancel && cancel->load(std::memory_order_relaxed)) return true; // nobody wants the answer any more
+    return millis > 0 && std::chrono::steady_clock::now() - start > std::chrono::milliseconds(millis);
+}
+
+//--------------------------------------------------------------
+SolveResult solve(const GameState &start, long budget, const std::atomic<bool> *cancel, int millis, int freeCells) {
+    auto began = std::chrono::steady_clock::now();
+    SolveResult result;
+    result.nodes = 0;
+    std::vector<Node> nodes; // every position generated
+    TranspositionTable seen;
+    typedef std::pair<int, int> entry; // priority, node index
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open; // smallest priority first
+    Node root;
+    root.state = start;
+    autoplay(root.state);
+    root.parent = -1;
+    root.depth = 0;
+    nodes.push_back(root);
+    seen.insert(root.state.canonicalKey());
+    open.push(entry(heuristic(root.state), 0));
+    int goal = -1;
+    while(!open.empty()) {
+        int idx = open.top().second;
+        if(nodes[idx].state.isWon()) { goal = idx; break; }
+        if(result.nodes >= budget) break; // the node stays open so running out doesn't look like the end of the search
+        if(stopped(result.nodes, cancel, millis, began)) break;
+        open.pop();
+        result.nodes++;
+        MoveList list;
+        generateMoves(nodes[idx].state, list);
+        for(int i = 0; i < list.size; i++) {
+            if(freeCells < NUMBER_OF_FREECELLS && !fitsFreeCells(nodes[idx].state, list.moves[i], freeCells)) continue;
+            Node child;
+            child.state = nodes[idx].state;
+            child.state.apply(list.moves[i]);
+            autoplay(child.state);
+            if(!seen.insert(child.state.canonicalKey())) continue; // already reached in some arrangement
+            child.parent = idx;
+            child.move = list.moves[i];
+            child.depth = nodes[idx].depth + 1;
+            nodes.push_back(child);
+            open.push(entry(2 * heuristic(child.state) + child.depth, nodes.size() - 1)); // mostly greedy, depth keeps it short
+        }
+    }
+    if(goal == -1) {
+        result.status = open.empty() ? UNSOLVABLE : GAVE_UP;
+        return result;
+    }
+    std::vector<Move> path; // moves chosen by the search from the goal back to the start
+    for(int i = goal; nodes[i].parent != -1; i = nodes[i].parent) path.push_back(nodes[i].move);
+    GameState s = start; // replay to put the automatic moves back in
+    autoplay(s, &result.moves);
+    for(int i = path.size() - 1; i >= 0; i--) {
+        s.apply(path[i]);
+        result.moves.push_back(path[i]);
+        autoplay(s, &result.moves);
+    }
+    result.status = SOLVED;
+    return result;
+}
+
+//--------------------------------------------------------------
+ProgressStatus findProgress(const GameState &start, long budget, const std::atomic<bool> *cancel, int millis) {
+    auto began = std::chrono::steady_clock::now();
+    TranspositionTable seen;
+    std::vector<GameState> stack(1, start);
+    seen.insert(start.canonicalKey());
+    long nodes = 0;
+    MoveList list;
+    while(!stack.empty()) {
+        if(nodes >= budget || stopped(nodes, cancel, millis, began)) return PROGRESS_UNKNOWN;
+        nodes++;
+        GameState s = stack.back();
+        stack.pop_back();
+        generateMoves(s, list);
+        for(int i = 0; i < list.size; i++) {
+            if(list.moves[i].to >= HOME_BASE) return PROGRESS;
+            GameState child = s;
+            child.apply(list.moves[i]);
+            if(seen.insert(child.canonicalKey())) stack.push_back(child);
+        }
+    }
+    return NO_PROGRESS;
+}
@@ -0,0 +1,45 @@
+
+
+#ifndef solver_hpp
+#define solver_hpp
+
+#include "gameState.hpp"
+#include <atomic>
+#include <vector>
+
+#define SOLVER_BUDGET 200000 // positions a full solve may expand
+#define HINT_BUDGET 20000 // positions hint may search before falling back
+
+//------------------------------------------------------------------------------
+
+enum SolveStatus {
+    SOLVED, // moves lead to every card at home
+    UNSOLVABLE, // every reachable position was searched
+    GAVE_UP // ran out of budget
+};
+
+enum ProgressStatus {
+    PROGRESS, // some card can still reach home
+    NO_PROGRESS, // every reachable position was searched and none sends a card home
+    PROGRESS_UNKNOWN // ran out of budget or time
+};
+
+struct SolveResult {
+    SolveStatus status;
+    std::vector<Move> moves; // full solution including the cards sent home automatically
+    long nodes; // positions expanded
+};
+
+// best-first search from the position, positions already seen are skipped through a transposition table,
+// setting cancel from another thread or running longer than millis (0 for no limit) stops it like running out of budget
+// freeCells below NUMBER_OF_FREECELLS plays as if the table had fewer of them
+SolveResult solve(const GameState &start, long budget = SOLVER_BUDGET, const std::atomic<bool> *cancel = nullptr, int millis = 0,
+    int freeCells = NUMBER_OF_FREECELLS);
+
+// depth-first search for any move that sends a card home, stops like solve
+ProgressStatus findProgress(const GameState &start, long budget = SOLVER_BUDGET, const std::atomic<bool> *cancel = nullptr, int millis = 0);
+
+// sends home every card that no other card will need to be stacked on, returns amount of cards moved
+int autoplay(GameState &s, std::vector<Move> *played = nullptr);
+
+#endif /* solver_hpp */
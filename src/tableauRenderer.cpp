@@ -0,0 +1,64 @@
+
+
+#include "tableauRenderer.hpp"
+
+//--------------------------------------------------------------
+TableauRenderer::TableauRenderer() : atlas(nullptr) {
+    mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::setAtlas(const CardAtlas &a) {
+    atlas = &a;
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::clear() { // start a new table, the buffers keep their memory
+    mesh.clear();
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::addPicture(int cell, const ofVec2f &pos, const ofVec2f &size, const ofColor &col) {
+    addQuad(pos, size, atlas->getCellPosition(cell), atlas->getCellSize(), col);
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::addRectangle(const ofVec2f &pos, const ofVec2f &size, const ofColor &col) {
+    ofVec2f white = atlas->getCellPosition(ATLAS_WHITE) + atlas->getCellSize() / 2; // middle of the white cell
+    addQuad(pos, size, white, ofVec2f(0, 0), col);
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::addBorder(const ofVec2f &pos, const ofVec2f &size, const ofColor &col) { // one pixel wide like ofNoFill
+    addRectangle(pos, ofVec2f(size.x, 1), col); // top
+    addRectangle(pos + ofVec2f(0, size.y - 1), ofVec2f(size.x, 1), col); // bottom
+    addRectangle(pos + ofVec2f(0, 1), ofVec2f(1, size.y - 2), col); // left
+    addRectangle(pos + ofVec2f(size.x - 1, 1), ofVec2f(1, size.y - 2), col); // right
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::addQuad(const ofVec2f &pos, const ofVec2f &size, const ofVec2f &texPos, const ofVec2f &texSize, const ofColor &col) {
+    unsigned first = mesh.getNumVertices();
+    const ofTexture &texture = atlas->getTexture();
+    for(int i = 0; i < 4; i++) { // corners clockwise from the top left
+        float fx = (i == 1 || i == 2) ? 1 : 0;
+        float fy = (i >= 2) ? 1 : 0;
+        mesh.addVertex(ofVec3f(pos.x + fx * size.x, pos.y + fy * size.y, 0));
+        mesh.addTexCoord(texture.getCoordFromPoint(texPos.x + fx * texSize.x, texPos.y + fy * texSize.y)); // works for rectangle and normalised textures
+        mesh.addColor(col);
+    }
+    mesh.addIndex(first);
+    mesh.addIndex(first + 1);
+    mesh.addIndex(first + 2);
+    mesh.addIndex(first);
+    mesh.addIndex(first + 2);
+    mesh.addIndex(first + 3);
+}
+
+//--------------------------------------------------------------
+void TableauRenderer::draw() const {
+    if(!atlas || !atlas->isLoaded()) return;
+    atlas->getTexture().bind();
+    mesh.draw();
+    atlas->getTexture().unbind();
+}
@@ -0,0 +1,28 @@
+
+
+#ifndef tableauRenderer_hpp
+#define tableauRenderer_hpp
+
+#include "ofMain.h"
+#include "cardAtlas.hpp"
+
+//------------------------------------------------------------------------------
+
+// collects every pile, card face, border and overlay of the table into one mesh textured by the atlas,
+// plain colours sample the atlas' white cell so the whole table is a single draw call
+class TableauRenderer {
+public:
+    TableauRenderer();
+    void setAtlas(const CardAtlas &a);
+    void clear();
+    void addPicture(int cell, const ofVec2f &pos, const ofVec2f &size, const ofColor &col);
+    void addRectangle(const ofVec2f &pos, const ofVec2f &size, const ofColor &col);
+    void addBorder(const ofVec2f &pos, const ofVec2f &size, const ofColor &col);
+    void draw() const;
+private:
+    const CardAtlas *atlas; // texture every quad samples
+    ofVboMesh mesh; // the whole table
+    void addQuad(const ofVec2f &pos, const ofVec2f &size, const ofVec2f &texPos, const ofVec2f &texSize, const ofColor &col);
+};
+
+#endif /* tableauRenderer_hpp */
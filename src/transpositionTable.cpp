@@ -0,0 +1,52 @@
+
+
+#include "transpositionTable.hpp"
+
+//--------------------------------------------------------------
+TranspositionTable::TranspositionTable(int bits) : slots(1ULL << bits, 0), mask((1ULL << bits) - 1), used(0) {}
+
+//--------------------------------------------------------------
+bool TranspositionTable::insert(uint64_t key) { // returns false if the key was already there
+    if(key == 0) key = 1; // 0 is the empty marker
+    if(2 * (used + 1) > (int)slots.size()) grow();
+    uint64_t i = key & mask;
+    while(slots[i] != 0) {
+        if(slots[i] == key) return false; // seen before
+        i = (i + 1) & mask; // linear probing
+    }
+    slots[i] = key;
+    used++;
+    return true;
+}
+
+//--------------------------------------------------------------
+bool TranspositionTable::contains(uint64_t key) const {
+    if(key == 0) key = 1;
+    uint64_t i = key & mask;
+    while(slots[i] != 0) {
+        if(slots[i] == key) return true;
+        i = (i + 1) & mask;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------
+void TranspositionTable::clear() {
+    for(int i = 0; i < slots.size(); i++) slots[i] = 0;
+    used = 0;
+}
+
+//--------------------------------------------------------------
+int TranspositionTable::size() const {
+    return used;
+}
+
+//--------------------------------------------------------------
+void TranspositionTable::grow() { // double the table and put every key back
+    std::vector<uint64_t> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, 0);
+    mask = slots.size() - 1;
+    used = 0;
+    for(int i = 0; i < old.size(); i++) if(old[i] != 0) insert(old[i]);
+}
@@ -0,0 +1,26 @@
+
+
+#ifndef transpositionTable_hpp
+#define transpositionTable_hpp
+
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// open addressing set of 64 bit position keys, grows when half full
+class TranspositionTable {
+public:
+    TranspositionTable(int bits = 16);
+    bool insert(uint64_t key);
+    bool contains(uint64_t key) const;
+    void clear();
+    int size() const;
+private:
+    std::vector<uint64_t> slots; // 0 marks an empty slot
+    uint64_t mask; // slots.size() - 1
+    int used; // amount of keys stored
+    void grow();
+};
+
+#endif /* transpositionTable_hpp */
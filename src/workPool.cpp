@@ -0,0 +1,61 @@
+
+
+#include "workPool.hpp"
+#include <thread>
+
+//--------------------------------------------------------------
+WorkPool::WorkPool(int t) : threads(t) {
+    if(threads <= 0) threads = std::thread::hardware_concurrency(); // every core
+    if(threads <= 0) threads = 1;
+}
+
+//--------------------------------------------------------------
+int WorkPool::getThreads() {
+    return threads;
+}
+
+//--------------------------------------------------------------
+void WorkPool::forEach(long first, long last, const std::function<void(long, int)> &job, long grain) {
+    std::vector<Queue> fresh(threads);
+    queues.swap(fresh);
+    int w = 0;
+    for(long i = first; i < last; i += grain) { // deal the chunks out in turns so everyone starts near the front
+        Chunk c = {i, (i + grain < last) ? i + grain : last};
+        queues[w].chunks.push_front(c); // the owner works from the back
+        w = (w + 1) % threads;
+    }
+    std::vector<std::thread> workers;
+    for(int i = 1; i < threads; i++) workers.push_back(std::thread(&WorkPool::work, this, i, std::cref(job)));
+    work(0, job); // the calling thread works too
+    for(int i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+//--------------------------------------------------------------
+bool WorkPool::take(int worker, Chunk &c) {
+    {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        if(!queues[worker].chunks.empty()) { // own work first, in order
+            c = queues[worker].chunks.back();
+            queues[worker].chunks.pop_back();
+            return true;
+        }
+    }
+    for(int i = 1; i < threads; i++) { // steal the chunk someone else would reach last
+        Queue &q = queues[(worker + i) % threads];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if(!q.chunks.empty()) {
+            c = q.chunks.front();
+            q.chunks.pop_front();
+            return true;
+        }
+    }
+    return false; // nothing left anywhere
+}
+
+//--------------------------------------------------------------
+void WorkPool::work(int worker, const std::function<void(long, int)> &job) {
+    Chunk c;
+    while(take(worker, c)) {
+        for(long i = c.first; i < c.last; i++) job(i, worker);
+    }
+}
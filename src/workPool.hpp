@@ -0,0 +1,35 @@
+
+
+#ifndef workPool_hpp
+#define workPool_hpp
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+// runs a job for every number of a range on all cores
+// each worker takes chunks from the back of its own queue and steals from the front of the others when it runs dry
+class WorkPool {
+public:
+    WorkPool(int threads = 0);
+    int getThreads();
+    void forEach(long first, long last, const std::function<void(long item, int worker)> &job, long grain = 16);
+private:
+    struct Chunk {
+        long first; // first item
+        long last; // one past the last item
+    };
+    struct Queue {
+        std::mutex lock;
+        std::deque<Chunk> chunks;
+    };
+    int threads; // amount of workers
+    std::vector<Queue> queues; // one per worker
+    bool take(int worker, Chunk &c);
+    void work(int worker, const std::function<void(long, int)> &job);
+};
+
+#endif /* workPool_hpp */
@@ -0,0 +1,78 @@
+// Solves a range of deals on every core and prints one line per deal.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -pthread -I../../src main.cpp ../../src/gameState.cpp ../../src/moveGenerator.cpp
+//         ../../src/solver.cpp ../../src/transpositionTable.cpp ../../src/workPool.cpp ../../src/dealCorpus.cpp
+//         ../../src/simdDealer.cpp -o batchSolver
+// usage:
+//     batchSolver [first deal] [last deal] [threads] [budget] [corpus]
+// defaults to deals 0 - 31999 (everything newGame can pick) on all cores
+// deals found in the corpus file (see tools/dealCorpus) are read from it instead of shuffled
+
+#include "dealCorpus.hpp"
+#include "gameState.hpp"
+#include "solver.hpp"
+#include "workPool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------
+
+struct DealResult {
+    SolveStatus status;
+    int length; // moves in the solution
+    long nodes; // positions expanded
+    double seconds; // time spent on the deal
+};
+
+//--------------------------------------------------------------
+static const char* statusName(SolveStatus s) {
+    switch(s) {
+        case SOLVED: return "solved";
+        case UNSOLVABLE: return "unsolvable";
+        default: return "gave-up";
+    }
+}
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    long first = (argc > 1) ? atol(argv[1]) : 0;
+    long last = (argc > 2) ? atol(argv[2]) : 31999;
+    int threads = (argc > 3) ? atoi(argv[3]) : 0;
+    long budget = (argc > 4) ? atol(argv[4]) : SOLVER_BUDGET;
+    DealCorpus corpus;
+    if(argc > 5 && !corpus.open(argv[5])) fprintf(stderr, "can't map %s, shuffling deals instead\n", argv[5]);
+    if(last < first) {
+        fprintf(stderr, "usage: %s [first deal] [last deal] [threads] [budget] [corpus]\n", argv[0]);
+        return 1;
+    }
+    WorkPool pool(threads);
+    std::vector<DealResult> results(last - first + 1);
+    fprintf(stderr, "solving deals %ld - %ld on %d threads, budget %ld\n", first, last, pool.getThreads(), budget);
+    auto start = std::chrono::steady_clock::now();
+    pool.forEach(first, last + 1, [&](long deal, int) {
+        auto t = std::chrono::steady_clock::now();
+        SolveResult r = solve(corpus.contains(deal) ? GameState::deal(corpus.deal(deal)) : GameState::deal(deal), budget);
+        DealResult &out = results[deal - first];
+        out.status = r.status;
+        out.length = r.moves.size();
+        out.nodes = r.nodes;
+        out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+    });
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long solved = 0, unsolvable = 0, nodes = 0;
+    double cpu = 0;
+    printf("deal,result,length,nodes,nodes_per_sec\n");
+    for(long i = 0; i < results.size(); i++) {
+        const DealResult &r = results[i];
+        printf("%ld,%s,%d,%ld,%.0f\n", first + i, statusName(r.status), r.length, r.nodes, r.seconds > 0 ? r.nodes / r.seconds : 0.0);
+        if(r.status == SOLVED) solved++;
+        if(r.status == UNSOLVABLE) unsolvable++;
+        nodes += r.nodes;
+        cpu += r.seconds;
+    }
+    fprintf(stderr, "%ld deals: %ld solved, %ld unsolvable, %ld gave up\n", (long)results.size(), solved, unsolvable, (long)results.size() - solved - unsolvable);
+    fprintf(stderr, "%ld nodes in %.1fs (%.0f nodes/sec per thread, %.0f overall)\n", nodes, total, cpu > 0 ? nodes / cpu : 0.0, total > 0 ? nodes / total : 0.0);
+    return 0;
+}
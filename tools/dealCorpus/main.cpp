@@ -0,0 +1,44 @@
+// Writes every deal of a range into a corpus file that the game and the batch tools map from disk.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -march=native -I../../src main.cpp ../../src/gameState.cpp ../../src/dealCorpus.cpp ../../src/simdDealer.cpp -o dealCorpus
+// (-march=native lets the dealer shuffle 8 or 16 deals at once with AVX2 or AVX-512)
+// usage:
+//     dealCorpus [file] [first deal] [last deal]
+// defaults to ../../bin/data/deals.bin with deals 0 - 31999, the extended range is 0 - 2147483647
+
+#include "dealCorpus.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    const char *path = (argc > 1) ? argv[1] : "../../bin/data/deals.bin";
+    long first = (argc > 2) ? atol(argv[2]) : 0;
+    long last = (argc > 3) ? atol(argv[3]) : 31999;
+    if(first < 0 || last < first || last > 2147483647L) {
+        fprintf(stderr, "usage: %s [file] [first deal] [last deal]\n", argv[0]);
+        return 1;
+    }
+    if(!DealCorpus::write(path, first, last)) {
+        fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+    DealCorpus corpus; // read it back to make sure it maps
+    if(!corpus.open(path)) {
+        fprintf(stderr, "%s was written but can't be mapped\n", path);
+        return 1;
+    }
+    for(long id = first; id <= last; id += (last - first) / 16 + 1) { // spot check against shuffling
+        uint8_t order[NUMBER_OF_CARDS];
+        GameState::dealOrder(id, order);
+        for(int i = 0; i < NUMBER_OF_CARDS; i++) {
+            if(corpus.deal(id)[i] != order[i]) {
+                fprintf(stderr, "deal %ld differs from the shuffle\n", id);
+                return 1;
+            }
+        }
+    }
+    fprintf(stderr, "wrote deals %ld - %ld to %s (%ld bytes)\n", first, last, path, (long)sizeof(CorpusHeader) + (last - first + 1) * NUMBER_OF_CARDS);
+    return 0;
+}
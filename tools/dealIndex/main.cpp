@@ -0,0 +1,68 @@
+// Solves a range of deals with fewer and fewer free cells and writes the difficulty index the game picks deals from.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -pthread -I../../src main.cpp ../../src/gameState.cpp ../../src/moveGenerator.cpp
+//         ../../src/solver.cpp ../../src/transpositionTable.cpp ../../src/workPool.cpp ../../src/dealCorpus.cpp
+//         ../../src/simdDealer.cpp ../../src/dealIndex.cpp -o dealIndex
+// usage:
+//     dealIndex [file] [first deal] [last deal] [threads] [budget] [corpus]
+// defaults to ../../bin/data/deals.index with deals 0 - 31999 (everything newGame can pick) on all cores
+// deals found in the corpus file (see tools/dealCorpus) are read from it instead of shuffled
+
+#include "dealCorpus.hpp"
+#include "dealIndex.hpp"
+#include "workPool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    const char *path = (argc > 1) ? argv[1] : "../../bin/data/deals.index";
+    long first = (argc > 2) ? atol(argv[2]) : 0;
+    long last = (argc > 3) ? atol(argv[3]) : 31999;
+    int threads = (argc > 4) ? atoi(argv[4]) : 0;
+    long budget = (argc > 5) ? atol(argv[5]) : SOLVER_BUDGET;
+    DealCorpus corpus;
+    if(argc > 6 && !corpus.open(argv[6])) fprintf(stderr, "can't map %s, shuffling deals instead\n", argv[6]);
+    if(first < 0 || last < first || last > 2147483647L) {
+        fprintf(stderr, "usage: %s [file] [first deal] [last deal] [threads] [budget] [corpus]\n", argv[0]);
+        return 1;
+    }
+    WorkPool pool(threads);
+    std::vector<DealInfo> deals(last - first + 1);
+    fprintf(stderr, "indexing deals %ld - %ld on %d threads, budget %ld\n", first, last, pool.getThreads(), budget);
+    auto start = std::chrono::steady_clock::now();
+    pool.forEach(first, last + 1, [&](long deal, int) {
+        GameState s = corpus.contains(deal) ? GameState::deal(corpus.deal(deal)) : GameState::deal(deal);
+        SolveResult r = solve(s, budget);
+        DealInfo &d = deals[deal - first];
+        d.status = r.status;
+        d.nodes = r.nodes;
+        d.length = r.status == SOLVED ? r.moves.size() : 0;
+        d.freeCells = r.status == SOLVED ? NUMBER_OF_FREECELLS : NOT_SOLVED;
+        for(int cells = NUMBER_OF_FREECELLS - 1; cells >= 0 && d.freeCells == cells + 1; cells--) { // until a run fails
+            SolveResult fewer = solve(s, budget, nullptr, 0, cells);
+            if(fewer.status != SOLVED) break;
+            d.freeCells = cells;
+            if(fewer.moves.size() < d.length) d.length = fewer.moves.size(); // shortest solution found by any run
+        }
+    });
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(!DealIndex::write(path, first, deals)) {
+        fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+    DealIndex index; // read it back to make sure it maps
+    if(!index.open(path)) {
+        fprintf(stderr, "%s was written but can't be mapped\n", path);
+        return 1;
+    }
+    long unsolved = deals.size();
+    for(int level = 0; level < DIFFICULTY_LEVELS; level++) {
+        fprintf(stderr, "%-7s %d deals\n", DealIndex::levelName((DealDifficulty)level), index.levelSize((DealDifficulty)level));
+        unsolved -= index.levelSize((DealDifficulty)level);
+    }
+    fprintf(stderr, "%ld deals not solved, indexed in %.1fs into %s\n", unsolved, total, path);
+    return 0;
+}
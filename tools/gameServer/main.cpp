@@ -0,0 +1,260 @@
+// Runs many games at once without a window, for tournaments and bots.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -I../../src main.cpp ../../src/gameState.cpp ../../src/moveLog.cpp ../../src/sessionPool.cpp -o gameServer
+// usage:
+//     gameServer                      commands on stdin, answers on stdout
+//     gameServer --socket path        any number of clients on a local Unix socket, all sharing the sessions
+//     gameServer --bench [sessions]   plays random moves in that many sessions and prints the speed
+// one command per line, one answer per command:
+//     new <deal>                      ok <id> <deal>
+//     show <id>                       table <id> <column 0> ... <column 7> <free cells> <homes> <score> <moves>
+//     move <id> <from> <to> <count>   moved <id> <from> <to> <count> <card> <score> <moves> <won>
+//     undo <id>                       moved ... with the reverted move, from and to swapped (the last SESSION_LOG moves)
+//     redo <id>                       moved ...
+//     close <id>                      ok <id>
+//     stats                           stats <sessions> <bytes>
+// locations are 0-7 for columns, 8-11 for free cells and 12-15 for the homes of clubs, diamonds, hearts and spades,
+// cards are 0-51 (rank * 4 + suit), piles are printed bottom up separated by commas with - when empty
+// failed commands answer: error <id> <reason>
+
+#include "sessionPool.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define READ_SIZE 65536 // bytes read from a client at once
+
+//------------------------------------------------------------------------------
+
+struct Client {
+    Client(int i, int o) : in(i), out(o) {}
+    int in; // file descriptors, the same one for a socket
+    int out;
+    std::string input; // received bytes not yet forming a full line
+    std::string output; // answers not yet sent
+};
+
+//--------------------------------------------------------------
+static void addPile(std::string &out, const uint8_t *cards, int n) {
+    char buf[8];
+    out += ' ';
+    if(n == 0) out += '-';
+    for(int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), i ? ",%d" : "%d", cards[i]);
+        out += buf;
+    }
+}
+
+//--------------------------------------------------------------
+static void showTable(const Session &s, std::string &out) {
+    char buf[64];
+    uint8_t pile[NUMBER_OF_CARDS];
+    snprintf(buf, sizeof(buf), "table %u", s.id);
+    out += buf;
+    for(int c = 0; c < NUMBER_OF_COLUMNS; c++) {
+        for(int r = 0; r < s.state.columnSize(c); r++) pile[r] = s.state.columnCard(c, r);
+        addPile(out, pile, s.state.columnSize(c));
+    }
+    int n = 0;
+    for(int i = 0; i < NUMBER_OF_FREECELLS; i++) if(s.state.freeCell(i) != NO_CARD) pile[n++] = s.state.freeCell(i);
+    addPile(out, pile, n);
+    for(int i = 0; i < NUMBER_OF_HOMES; i++) pile[i] = s.state.homeRank(i); // cards at home of each suit
+    addPile(out, pile, NUMBER_OF_HOMES);
+    snprintf(buf, sizeof(buf), " %d %d\n", s.score, s.moves);
+    out += buf;
+}
+
+//--------------------------------------------------------------
+static void handle(SessionPool &pool, const char *line, std::string &out) { // one command, appends its answer
+    char cmd[16];
+    unsigned id = 0;
+    int a = 0, b = 0, c = 0;
+    char buf[128];
+    int n = sscanf(line, "%15s %u %d %d %d", cmd, &id, &a, &b, &c);
+    if(n < 1) return; // empty line
+    SessionResult r = SESSION_OK;
+    SessionDelta d;
+    if(!strcmp(cmd, "new")) {
+        int deal = id;
+        if(n < 2 || deal < 0) r = SESSION_NO_GAME;
+        else if((id = pool.open(deal)) == 0) r = SESSION_POOL_FULL;
+        else {
+            snprintf(buf, sizeof(buf), "ok %u %d\n", id, deal);
+            out += buf;
+            return;
+        }
+    } else if(!strcmp(cmd, "show")) {
+        const Session *s = pool.get(id);
+        if(!s) r = SESSION_NO_GAME;
+        else {
+            showTable(*s, out);
+            return;
+        }
+    } else if(!strcmp(cmd, "close")) {
+        r = pool.close(id);
+        if(r == SESSION_OK) {
+            snprintf(buf, sizeof(buf), "ok %u\n", id);
+            out += buf;
+            return;
+        }
+    } else if(!strcmp(cmd, "stats")) {
+        snprintf(buf, sizeof(buf), "stats %d %zu\n", pool.size(), pool.memory());
+        out += buf;
+        return;
+    } else {
+        if(!strcmp(cmd, "move")) {
+            Move m;
+            m.from = a;
+            m.to = b;
+            m.count = c;
+            if(n < 5 || a < 0 || b < 0 || c < 0 || a > 255 || b > 255 || c > 255) r = SESSION_ILLEGAL_MOVE;
+            else r = pool.move(id, m, d);
+        } else if(!strcmp(cmd, "undo")) r = pool.undo(id, d);
+        else if(!strcmp(cmd, "redo")) r = pool.redo(id, d);
+        else {
+            snprintf(buf, sizeof(buf), "error - unknown command %.15s\n", cmd);
+            out += buf;
+            return;
+        }
+        if(r == SESSION_OK) {
+            snprintf(buf, sizeof(buf), "moved %u %d %d %d %d %d %d %d\n", id, d.from, d.to, d.count, d.card, d.score, d.moves, d.won);
+            out += buf;
+            return;
+        }
+    }
+    snprintf(buf, sizeof(buf), "error %u %s\n", id, resultName(r));
+    out += buf;
+}
+
+//--------------------------------------------------------------
+static bool receive(SessionPool &pool, Client &c) { // handles every full line that arrived, false once the client is gone
+    char buf[READ_SIZE];
+    ssize_t n = read(c.in, buf, sizeof(buf));
+    if(n <= 0) return false;
+    c.input.append(buf, n);
+    size_t start = 0, end;
+    while((end = c.input.find('\n', start)) != std::string::npos) {
+        c.input[end] = 0;
+        handle(pool, c.input.c_str() + start, c.output);
+        start = end + 1;
+    }
+    c.input.erase(0, start);
+    return true;
+}
+
+//--------------------------------------------------------------
+static bool send(Client &c) { // writes what it can, false when the client can't take answers any more
+    while(!c.output.empty()) {
+        ssize_t n = c.in == c.out ? ::send(c.out, c.output.data(), c.output.size(), MSG_NOSIGNAL | MSG_DONTWAIT) :
+            write(c.out, c.output.data(), c.output.size());
+        if(n < 0) return c.in == c.out && (errno == EAGAIN || errno == EWOULDBLOCK); // full socket, poll says when to go on
+        c.output.erase(0, n);
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+static int serveStdin(SessionPool &pool) {
+    Client c(0, 1);
+    while(receive(pool, c)) if(!send(c)) return 1; // answers of a whole read go out in one write
+    return send(c) ? 0 : 1;
+}
+
+//--------------------------------------------------------------
+static int serveSocket(SessionPool &pool, const char *path) { // one thread polls every client, the sessions stay on one core
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(server < 0 || strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "can't create socket %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+    unlink(path); // left over from an earlier run
+    if(bind(server, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(server, 64) != 0) {
+        fprintf(stderr, "can't listen on %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "listening on %s\n", path);
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    while(true) {
+        fds.resize(clients.size() + 1);
+        fds[0].fd = server;
+        fds[0].events = POLLIN;
+        for(int i = 0; i < clients.size(); i++) {
+            fds[i + 1].fd = clients[i].in;
+            fds[i + 1].events = clients[i].output.empty() ? POLLIN : POLLIN | POLLOUT;
+        }
+        if(poll(fds.data(), fds.size(), -1) < 0) {
+            if(errno == EINTR) continue;
+            fprintf(stderr, "poll failed: %s\n", strerror(errno));
+            return 1;
+        }
+        for(int i = clients.size() - 1; i >= 0; i--) { // backwards so dropping a client keeps the other indices
+            short ev = fds[i + 1].revents;
+            bool alive = true;
+            if(ev & (POLLIN | POLLHUP | POLLERR)) alive = receive(pool, clients[i]);
+            if(alive) alive = send(clients[i]);
+            if(!alive) {
+                close(clients[i].in);
+                clients.erase(clients.begin() + i); // its sessions stay, another connection can continue them
+            }
+        }
+        if(fds[0].revents & POLLIN) {
+            int fd = accept(server, nullptr, nullptr);
+            if(fd >= 0) clients.push_back(Client(fd, fd));
+        }
+    }
+}
+
+//--------------------------------------------------------------
+static int bench(SessionPool &pool, int sessions) { // commands go through the same parser as on the wire
+    std::mt19937 rng(1);
+    std::vector<unsigned> ids(sessions);
+    std::string out;
+    char line[64];
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < sessions; i++) ids[i] = pool.open(i % 32000 + 1);
+    double opened = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long commands = 0, moved = 0;
+    start = std::chrono::steady_clock::now();
+    for(int round = 0; round < 100; round++) {
+        for(int i = 0; i < sessions; i++) {
+            int kind = rng() % 10;
+            if(kind == 0) snprintf(line, sizeof(line), "undo %u", ids[i]);
+            else if(kind == 1) snprintf(line, sizeof(line), "redo %u", ids[i]);
+            else snprintf(line, sizeof(line), "move %u %d %d 1", ids[i], (int)(rng() % HOME_BASE), (int)(rng() % (HOME_BASE + NUMBER_OF_HOMES)));
+            out.clear();
+            handle(pool, line, out);
+            commands++;
+            if(out[0] == 'm') moved++;
+        }
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%d sessions opened in %.3fs, %zu bytes (%zu per session)\n", pool.size(), opened, pool.memory(), sizeof(Session));
+    fprintf(stderr, "%ld commands (%ld changed a table) in %.3fs, %.0f commands/sec\n", commands, moved, total, commands / total);
+    return 0;
+}
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    SessionPool pool;
+    if(argc > 2 && !strcmp(argv[1], "--socket")) return serveSocket(pool, argv[2]);
+    if(argc > 1 && !strcmp(argv[1], "--bench")) return bench(pool, argc > 2 ? atoi(argv[2]) : 10000);
+    if(argc > 1) {
+        fprintf(stderr, "usage: %s [--socket path | --bench sessions]\n", argv[0]);
+        return 1;
+    }
+    return serveStdin(pool);
+}
@@ -0,0 +1,395 @@
+// Times the rules engine behind every click and compares it with a stored baseline.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -I../../src main.cpp ../../src/gameState.cpp ../../src/moveGenerator.cpp ../../src/moveLog.cpp
+//         ../../src/solver.cpp ../../src/transpositionTable.cpp -o microBench
+// usage:
+//     microBench [baseline] [--save]
+// defaults to baseline.txt next to this file, --save replaces it with this run
+// every scenario uses fixed seeds and deals, prints ns and heap allocations per operation as the median of BENCH_RUNS runs
+// and exits with 1 when one got BENCH_TOLERANCE slower or allocates more than in the baseline
+// slower is judged on the time next to a fixed arithmetic loop timed along with every scenario, so a machine
+// that runs faster or slower as a whole (frequency scaling, busy neighbours) doesn't count, and only when the
+// slowdown shows up again in the BENCH_CONFIRM runs after it
+
+#include "gameState.hpp"
+#include "moveGenerator.hpp"
+#include "moveLog.hpp"
+#include "solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define BENCH_REPEATS 5 // runs of each scenario, the fastest counts
+#define BENCH_MIN_TIME 50 // milliseconds each run lasts at least
+#define BENCH_TOLERANCE 0.5 // slowdown reported as a regression, calibrated medians still move by a third between runs on a busy core
+#define BENCH_RUNS 5 // whole runs each result is the median of, single runs on a busy machine differ by half
+#define BENCH_CONFIRM 2 // extra median runs a slowdown has to show up in again before it counts
+#define CALIBRATION_STEPS 2000000 // length of the arithmetic loop the scenarios are timed against
+#define BENCH_POSITIONS 64 // positions the validation scenarios go through
+
+//------------------------------------------------------------------------------
+
+static long allocations = 0; // operator new calls so far
+
+void* operator new(size_t size) {
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+//------------------------------------------------------------------------------
+
+struct BenchResult {
+    std::string name;
+    double ns; // per operation
+    double steps; // ns per operation over ns per calibration step, what regressions are judged on
+    double allocs; // per operation
+};
+
+//--------------------------------------------------------------
+static double calibrate() { // ns per step of a loop that only needs the core, how fast the machine is right now
+    uint64_t x = 1;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < CALIBRATION_STEPS; i++) { // xorshift, nothing to optimise away
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        x *= 0x9E3779B97F4A7C15ULL;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALIBRATION_STEPS;
+    if(x == 42) fprintf(stderr, "\n");
+    return ns;
+}
+
+//--------------------------------------------------------------
+static BenchResult measure(const std::string &name, const std::function<long()> &run) { // run returns the operations it did
+    run(); // warm up caches and buffers
+    BenchResult r = {name, 0, 0, 0};
+    for(int i = 0; i < BENCH_REPEATS; i++) {
+        double step = calibrate(); // right before, the machine's speed drifts
+        long before = allocations;
+        long ops = 0;
+        double elapsed = 0;
+        auto start = std::chrono::steady_clock::now();
+        while(elapsed < BENCH_MIN_TIME) { // short scenarios run many times so the clock is accurate
+            ops += run();
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        double ns = elapsed * 1e6 / ops;
+        if(i == 0 || ns < r.ns) r.ns = ns;
+        if(i == 0 || ns / step < r.steps) r.steps = ns / step;
+        r.allocs = (double)(allocations - before) / ops;
+    }
+    return r;
+}
+
+//--------------------------------------------------------------
+static std::vector<GameState> positions() { // deals played a few random moves in, the same on every run
+    std::mt19937 rng(7);
+    std::vector<GameState> list;
+    for(int i = 0; i < BENCH_POSITIONS; i++) {
+        GameState s = GameState::deal(i + 1);
+        int steps = rng() % 40;
+        MoveList moves;
+        for(int j = 0; j < steps; j++) {
+            generateMoves(s, moves);
+            if(moves.size == 0) break;
+            s.apply(moves.moves[rng() % moves.size]);
+        }
+        list.push_back(s);
+    }
+    return list;
+}
+
+//--------------------------------------------------------------
+static GameState blocked() { // a position hint can't solve, found by playing badly
+    std::mt19937 rng(11);
+    for(int deal = 1; ; deal++) {
+        GameState s = GameState::deal(deal);
+        MoveList moves;
+        for(int j = 0; j < 200; j++) { // free cells and empty columns get used up
+            generateMoves(s, moves);
+            int pick = -1;
+            for(int k = 0; k < moves.size; k++) if(moves.kinds[k] == CARD_TO_FC || moves.kinds[k] == CARD_TO_REG) pick = k;
+            if(pick == -1) break;
+            s.apply(moves.moves[pick]);
+            if(rng() % 4 == 0 && solve(s, HINT_BUDGET).status != SOLVED) return s;
+        }
+    }
+}
+
+//--------------------------------------------------------------
+static GameState stackMove(int count, Move &m) { // a position where moving count cards onto another card is legal
+    std::mt19937 rng(13);
+    for(int deal = 1; deal <= 32000; deal++) {
+        GameState s = GameState::deal(deal);
+        MoveList moves;
+        for(int j = 0; j < 200; j++) { // random play until such a move comes up
+            generateMoves(s, moves);
+            if(moves.size == 0) break;
+            for(int k = 0; k < moves.size; k++) {
+                if(moves.kinds[k] != CARD_TO_CARD || moves.moves[k].count != count) continue;
+                m = moves.moves[k];
+                return s;
+            }
+            s.apply(moves.moves[rng() % moves.size]);
+        }
+    }
+    fprintf(stderr, "no position with a legal move of %d cards\n", count);
+    exit(1);
+}
+
+//--------------------------------------------------------------
+static std::vector<BenchResult> runAll() {
+    std::vector<BenchResult> results;
+    std::vector<GameState> list = positions();
+    long sink = 0; // keeps the optimiser from dropping the work
+
+    // Deck::arrangeCards
+    results.push_back(measure("deal shuffle", [&]() {
+        for(int i = 1; i <= 10000; i++) sink += GameState::deal(i).hash();
+        return 10000L;
+    }));
+    std::vector<uint8_t> orders(1000 * NUMBER_OF_CARDS);
+    for(int i = 0; i < 1000; i++) GameState::dealOrder(i + 1, &orders[i * NUMBER_OF_CARDS]);
+    results.push_back(measure("deal from corpus", [&]() {
+        for(int i = 0; i < 1000; i++) sink += GameState::deal(&orders[i * NUMBER_OF_CARDS]).hash();
+        return 1000L;
+    }));
+
+    // Deck::anotherCard, Deck::enoughSpace and Deck::checkHomes
+    results.push_back(measure("canStack", [&]() {
+        for(int a = 0; a < NUMBER_OF_CARDS; a++) for(int b = 0; b < NUMBER_OF_CARDS; b++) sink += GameState::canStack(a, b);
+        return (long)NUMBER_OF_CARDS * NUMBER_OF_CARDS;
+    }));
+    results.push_back(measure("capacity", [&]() {
+        for(int i = 0; i < list.size(); i++) sink += list[i].capacity(0) + list[i].capacity(1);
+        return (long)list.size() * 2;
+    }));
+    results.push_back(measure("isLegal", [&]() {
+        long ops = 0;
+        for(int i = 0; i < list.size(); i++) {
+            for(int from = 0; from < HOME_BASE; from++) for(int to = 0; to < HOME_BASE + NUMBER_OF_HOMES; to++) {
+                Move m = {(uint8_t)from, (uint8_t)to, 1};
+                sink += list[i].isLegal(m);
+                ops++;
+            }
+        }
+        return ops;
+    }));
+
+    // Deck::moveCard, the rules are checked by isLegal above
+    const int stacks[] = {1, 3, 6};
+    for(int k = 0; k < 3; k++) {
+        Move m;
+        GameState from = stackMove(stacks[k], m);
+        if(!from.isLegal(m)) { // undo brings the position back so the move stays legal on every round
+            fprintf(stderr, "moving %d cards is not legal in the position found for it\n", stacks[k]);
+            exit(1);
+        }
+        results.push_back(measure("moveCard stack of " + std::to_string(stacks[k]), [&, k, m, from]() {
+            GameState s = from;
+            MoveLog log;
+            log.reset(s);
+            for(int i = 0; i < 10000; i++) { // there and back through the log
+                s.apply(m);
+                log.push(m, s);
+                log.undo(s);
+            }
+            sink += s.hash();
+            return 10000L;
+        }));
+    }
+
+    // Deck::undo and Deck::redo over a whole won game
+    GameState start = GameState::deal(1);
+    std::vector<Move> solution = solve(start).moves;
+    MoveLog chain;
+    chain.reset(start);
+    GameState end = start;
+    for(int i = 0; i < solution.size(); i++) {
+        end.apply(solution[i]);
+        chain.push(solution[i], end);
+    }
+    results.push_back(measure("undo chain", [&]() {
+        for(int round = 0; round < 100; round++) {
+            while(chain.canUndo()) chain.undo(end);
+            while(chain.canRedo()) chain.redo(end);
+        }
+        sink += end.hash();
+        return 100L * 2 * solution.size();
+    }));
+
+    // Deck::hint
+    results.push_back(measure("hint open", [&]() {
+        for(int i = 0; i < 8; i++) sink += solve(list[i * 8], HINT_BUDGET).nodes;
+        return 8L;
+    }));
+    GameState stuck = blocked();
+    results.push_back(measure("hint blocked", [&]() {
+        sink += solve(stuck, HINT_BUDGET).nodes;
+        MoveList fallback;
+        generateMoves(stuck, fallback);
+        sink += fallback.size;
+        return 1L;
+    }));
+    std::unordered_map<uint64_t, Move> hintCache;
+    GameState walk = start;
+    for(int i = 0; i < solution.size(); i++) {
+        hintCache[walk.hash()] = solution[i];
+        walk.apply(solution[i]);
+    }
+    results.push_back(measure("hint cached", [&]() {
+        GameState s = start;
+        for(int i = 0; i < solution.size(); i++) {
+            auto it = hintCache.find(s.hash());
+            s.apply(it->second);
+        }
+        sink += s.hash();
+        return (long)solution.size();
+    }));
+
+    // Deck::checkAutocomplete and Deck::doAutocomplete
+    results.push_back(measure("checkAutocomplete", [&]() {
+        for(int i = 0; i < list.size(); i++) sink += list[i].isSorted();
+        return (long)list.size();
+    }));
+    GameState sorted = start;
+    for(int i = 0; i < solution.size() && !sorted.isSorted(); i++) sorted.apply(solution[i]);
+    results.push_back(measure("doAutocomplete", [&]() {
+        long ops = 0;
+        for(int round = 0; round < 100; round++) {
+            GameState s = sorted;
+            Move m;
+            while(nextHomeMove(s, m)) {
+                s.apply(m);
+                ops++;
+            }
+            sink += s.isWon();
+        }
+        return ops;
+    }));
+
+    if(sink == 42) fprintf(stderr, "\n");
+    return results;
+}
+
+//--------------------------------------------------------------
+static std::map<std::string, BenchResult> load(const char *path) {
+    std::map<std::string, BenchResult> baseline;
+    FILE *f = fopen(path, "r");
+    if(!f) return baseline;
+    char line[256];
+    while(fgets(line, sizeof(line), f)) {
+        char *a = strchr(line, ','); // name,ns,steps,allocs
+        if(!a || line[0] == '#') continue;
+        *a = 0;
+        BenchResult r = {line, 0, 0, 0};
+        if(sscanf(a + 1, "%lf,%lf,%lf", &r.ns, &r.steps, &r.allocs) == 3) baseline[r.name] = r;
+    }
+    fclose(f);
+    return baseline;
+}
+
+//--------------------------------------------------------------
+static bool save(const char *path, const std::vector<BenchResult> &results) {
+    FILE *f = fopen(path, "w");
+    if(!f) return false;
+    fprintf(f, "# name,ns per op,calibration steps per op,allocations per op (written by microBench --save)\n");
+    for(int i = 0; i < results.size(); i++) {
+        fprintf(f, "%s,%.2f,%.3f,%.3f\n", results[i].name.c_str(), results[i].ns, results[i].steps, results[i].allocs);
+    }
+    return fclose(f) == 0;
+}
+
+//--------------------------------------------------------------
+static std::vector<BenchResult> medianRun() { // median of several runs for each scenario, the baseline is made the same way
+    std::vector<std::vector<BenchResult>> runs;
+    for(int i = 0; i < BENCH_RUNS; i++) runs.push_back(runAll());
+    std::vector<BenchResult> results = runs[0];
+    for(int i = 0; i < results.size(); i++) {
+        std::vector<double> ns, steps;
+        for(int j = 0; j < runs.size(); j++) {
+            ns.push_back(runs[j][i].ns);
+            steps.push_back(runs[j][i].steps);
+            results[i].allocs = std::max(results[i].allocs, runs[j][i].allocs);
+        }
+        std::sort(ns.begin(), ns.end());
+        std::sort(steps.begin(), steps.end());
+        results[i].ns = ns[ns.size() / 2];
+        results[i].steps = steps[steps.size() / 2];
+    }
+    return results;
+}
+
+//--------------------------------------------------------------
+static bool slower(const BenchResult &r, const std::map<std::string, BenchResult> &baseline) {
+    auto it = baseline.find(r.name);
+    return it != baseline.end() && r.steps / it->second.steps - 1 > BENCH_TOLERANCE;
+}
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    const char *path = "baseline.txt";
+    bool store = false;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--save")) store = true;
+        else path = argv[i];
+    }
+    std::map<std::string, BenchResult> baseline = load(path);
+    std::vector<BenchResult> results = medianRun();
+    std::vector<bool> confirmed(results.size()); // slower in every run so far
+    bool any = false;
+    for(int i = 0; i < results.size(); i++) any |= confirmed[i] = !store && slower(results[i], baseline);
+    for(int round = 0; round < BENCH_CONFIRM && any; round++) { // a busy machine can make one run look slow, measure again
+        fprintf(stderr, "measuring again to confirm slowdowns\n");
+        std::vector<BenchResult> again = medianRun();
+        any = false;
+        for(int i = 0; i < results.size(); i++) any |= confirmed[i] = confirmed[i] && slower(again[i], baseline);
+    }
+    int regressions = 0;
+    printf("%-22s %14s %12s %14s %12s\n", "scenario", "ns/op", "allocs/op", "baseline ns", "change");
+    for(int i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        auto it = baseline.find(r.name);
+        if(it == baseline.end()) {
+            printf("%-22s %14.2f %12.3f %14s %12s\n", r.name.c_str(), r.ns, r.allocs, "-", "new");
+            continue;
+        }
+        double change = r.steps / it->second.steps - 1; // shown next to raw ns, but without the machine's own drift
+        bool allocates = r.allocs > it->second.allocs + 0.0005; // baseline is rounded to 3 digits
+        printf("%-22s %14.2f %12.3f %14.2f %+11.1f%%%s%s\n", r.name.c_str(), r.ns, r.allocs, it->second.ns, change * 100,
+            confirmed[i] ? " SLOWER" : "", allocates ? " ALLOCATES MORE" : "");
+        if(confirmed[i] || allocates) regressions++;
+    }
+    if(store) {
+        if(!save(path, results)) {
+            fprintf(stderr, "could not write %s\n", path);
+            return 1;
+        }
+        fprintf(stderr, "baseline saved to %s\n", path);
+        return 0;
+    }
+    if(baseline.empty()) fprintf(stderr, "no baseline in %s, run with --save to store one\n", path);
+    else fprintf(stderr, "%d regressions\n", regressions);
+    return regressions > 0 ? 1 : 0;
+}
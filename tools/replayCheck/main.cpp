@@ -0,0 +1,48 @@
+// Plays saved replays through the game rules and checks that their results could really happen.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -I../../src main.cpp ../../src/gameState.cpp ../../src/moveLog.cpp ../../src/replay.cpp -o replayCheck
+// usage:
+//     replayCheck replay.fcr [replay.fcr ...]
+// the game saves a replay of every finished game into ../../bin/data/replays
+// prints one line per replay and exits with 1 when any of them fails
+
+#include "replay.hpp"
+#include <chrono>
+#include <cstdio>
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s replay.fcr [replay.fcr ...]\n", argv[0]);
+        return 1;
+    }
+    std::vector<Replay> replays(argc - 1);
+    std::vector<bool> loaded(argc - 1);
+    for(int i = 1; i < argc; i++) loaded[i - 1] = replays[i - 1].load(argv[i]); // read everything first so only checking is timed
+    std::vector<ReplayVerdict> verdicts(replays.size());
+    std::vector<int> failed(replays.size());
+    long events = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < replays.size(); i++) {
+        if(!loaded[i]) continue;
+        verdicts[i] = validateReplay(replays[i], &failed[i]);
+        events += replays[i].getEvents().size();
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long ok = 0, bad = 0;
+    printf("file,deal,result,event\n");
+    for(int i = 0; i < replays.size(); i++) {
+        if(!loaded[i]) {
+            printf("%s,,unreadable,\n", argv[i + 1]);
+            bad++;
+            continue;
+        }
+        printf("%s,%d,%s,%d\n", argv[i + 1], replays[i].getHeader().deal, verdictName(verdicts[i]), failed[i]);
+        if(verdicts[i] == REPLAY_OK) ok++;
+        else bad++;
+    }
+    fprintf(stderr, "%ld replays: %ld ok, %ld failed\n", (long)replays.size(), ok, bad);
+    fprintf(stderr, "%ld events checked in %.3fs (%.0f replays/sec)\n", events, total, total > 0 ? replays.size() / total : 0.0);
+    return bad > 0 ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+// Checks that the solver only calls a deal unsolvable when it really searched everything.
+//
+// build (from this folder):
+//     c++ -std=c++14 -O2 -I../../src main.cpp ../../src/gameState.cpp ../../src/moveGenerator.cpp
+//         ../../src/solver.cpp ../../src/transpositionTable.cpp -o solverCheck
+// usage:
+//     solverCheck [first deal] [last deal]
+// defaults to deals 1 - 200, each is searched without free cells (so only a few moves are open at a time)
+// with budgets of 1 and 2 positions and once more cancelled before it starts, all of which must give up,
+// then with the millisecond limit the hint worker's searches have, which may only call it unsolvable when
+// the search without a limit does too
+// prints every failure and exits with 1 when there was one
+
+#include "solver.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK_BUDGETS 2 // smallest budgets tried, a budget this small never reaches the end of a deal
+#define CHECK_MILLIS 1 // time limit short enough to stop most searches
+
+//--------------------------------------------------------------
+static bool check(long deal, const char *what, const SolveResult &r) {
+    if(r.status == GAVE_UP) return true;
+    printf("deal %ld %s: %s after %ld positions, expected to give up\n", deal, what, r.status == SOLVED ? "solved" : "unsolvable", r.nodes);
+    return false;
+}
+
+//========================================================================
+int main(int argc, char* argv[]) {
+    long first = (argc > 1) ? atol(argv[1]) : 1;
+    long last = (argc > 2) ? atol(argv[2]) : 200;
+    if(first < 0 || last < first) {
+        fprintf(stderr, "usage: %s [first deal] [last deal]\n", argv[0]);
+        return 1;
+    }
+    long failed = 0, narrow = 0;
+    std::atomic<bool> cancel(true);
+    for(long deal = first; deal <= last; deal++) {
+        GameState s = GameState::deal(deal);
+        SolveResult full = solve(s, 2 * CHECK_BUDGETS, nullptr, 0, 0);
+        if(full.status != GAVE_UP) continue; // the whole search fits in the budgets, nothing to cut short
+        for(long budget = 1; budget <= CHECK_BUDGETS; budget++) {
+            char what[32];
+            snprintf(what, sizeof(what), "budget %ld", budget);
+            if(!check(deal, what, solve(s, budget, nullptr, 0, 0))) failed++;
+        }
+        if(!check(deal, "cancelled", solve(s, SOLVER_BUDGET, &cancel, 0, 0))) failed++; // stops at the first look at the flag
+        SolveResult timed = solve(s, SOLVER_BUDGET, nullptr, CHECK_MILLIS, 0);
+        if(timed.status == UNSOLVABLE && solve(s, SOLVER_BUDGET, nullptr, 0, 0).status != UNSOLVABLE) {
+            printf("deal %ld timed: unsolvable after %ld positions, the full search disagrees\n", deal, timed.nodes);
+            failed++;
+        }
+        narrow++;
+    }
+    printf("%ld deals checked, %ld failures\n", narrow, failed);
+    return failed ? 1 : 0;
+}